@@ -0,0 +1,138 @@
+/*
+ * alarm.c
+ *
+ * This file contains the proximity alarm, raised from the acquisition path as
+ * soon as the first echo of a sensor ends within the threshold, instead of
+ * waiting for the distance of the step in TaskStep and for the next screen
+ * refresh in TaskGui.
+ *
+ * The latency is the one of the echo edges: up to SYST_PERIOD when polling,
+ * the interrupt latency with the capture timer and up to SAMPLER_TASK_PERIOD
+ * with the DMA. There is no filtering nor consistency check, a single short
+ * echo is enough.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "alarm.h"
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static distance_t   alarm_threshold = 0;
+static uint_t       alarm_near = 0;     // Sensors raising the alarm, one bit
+                                        // for each of them
+static bool_t       alarm_on = false;   // Level of the output
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Sets the output as raised by the sensors, writing it only when it changes.
+ */
+void alarm_output()
+{
+    const bool_t on = BOOL(alarm_near != 0);
+
+    if(on == alarm_on)
+        return;
+
+    alarm_on = on;
+    TM_GPIO_SetPinValue(ALARM_PORT, ALARM_PIN, on);
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Configures the alarm output, see alarm.h.
+ */
+void alarm_init()
+{
+    TM_GPIO_Init(ALARM_PORT,
+                ALARM_PIN,
+                TM_GPIO_Mode_OUT,
+                TM_GPIO_OType_PP,
+                TM_GPIO_PuPd_NOPULL,
+                TM_GPIO_Speed_High);
+
+    alarm_near = 0;
+    alarm_on = false;
+    TM_GPIO_SetPinLow(ALARM_PORT, ALARM_PIN);
+
+    alarm_set_threshold(CM_TO_DISTANCE(ALARM_CM_DEFAULT));
+}
+
+/*
+ * Sets the threshold of the alarm, see alarm.h.
+ */
+void alarm_set_threshold(distance_t threshold)
+{
+    if(threshold < 0)
+        threshold = 0;
+
+    if(threshold > SENSOR_DIST_MAX)
+        threshold = SENSOR_DIST_MAX;
+
+    alarm_threshold = threshold;
+
+    if(threshold == 0)
+    {
+        alarm_near = 0;
+        alarm_output();
+    }
+}
+
+/*
+ * Returns the threshold of the alarm, in number of ticks.
+ */
+distance_t alarm_get_threshold()
+{
+    return alarm_threshold;
+}
+
+/*
+ * Compares the first echo of a sensor with the threshold, see alarm.h.
+ */
+void alarm_update(int_t id, distance_t distance, bool_t ended)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return;
+
+    if(distance > alarm_threshold)
+        alarm_near &= ~(1u << id);
+    else if(ended && alarm_threshold > 0)
+        alarm_near |= 1u << id;
+
+    alarm_output();
+}
+
+/*
+ * Lowers the alarm for a sensor that saw no echo.
+ */
+void alarm_clear(int_t id)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return;
+
+    alarm_near &= ~(1u << id);
+    alarm_output();
+}
+
+/*
+ * Tells whether the alarm is raised.
+ */
+bool_t alarm_is_on()
+{
+    return alarm_on;
+}
@@ -0,0 +1,74 @@
+/*
+ * alarm.h
+ *
+ * This file contains all declaration of public functions defined in the
+ * alarm.c file.
+ *
+ * */
+
+#ifndef ALARM_H
+#define ALARM_H
+
+#include "hal.h"
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define ALARM_PORT      (GPIOD)         // Output raised while an object is
+#define ALARM_PIN       (GPIO_Pin_15)   // near, the blue led of the board
+
+/*
+ * Distance in cm under which the alarm is raised by default, see
+ * alarm_set_threshold. Defining __PROXIMITY_ALARM__ enables the alarm.
+ */
+#if defined(__PROXIMITY_ALARM__)
+#define ALARM_CM_DEFAULT    (30)
+#else
+#define ALARM_CM_DEFAULT    (0)
+#endif
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Configures the alarm output, lowered, and sets the default threshold.
+ */
+extern void alarm_init();
+
+/*
+ * Sets the distance, in number of ticks (see CM_TO_DISTANCE), up to which the
+ * first echo of a sensor raises the alarm, limited to SENSOR_DIST_MAX. Zero
+ * disables the alarm and lowers its output.
+ */
+extern void alarm_set_threshold(distance_t threshold);
+
+/*
+ * Returns the threshold of the alarm, in number of ticks.
+ */
+extern distance_t alarm_get_threshold();
+
+/*
+ * Compares the first echo of the current trigger of a sensor, lasting the
+ * given ticks so far, with the threshold. An echo ended within it raises the
+ * alarm, an echo beyond it, ended or not, lowers the alarm for that sensor.
+ * Called by the acquisition path, so the output changes immediately.
+ */
+extern void alarm_update(int_t id, distance_t distance, bool_t ended);
+
+/*
+ * Lowers the alarm for a sensor that saw no echo at its last trigger.
+ */
+extern void alarm_clear(int_t id);
+
+/*
+ * Tells whether the alarm is raised by any sensor.
+ */
+extern bool_t alarm_is_on();
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * background.c
+ *
+ * This file contains the model of the static background seen at each
+ * bearing, such as the walls of a fixed installation, so that only the
+ * distances of the objects in the foreground need to be shown.
+ *
+ * The background of a bearing is the average of its distances, along with
+ * their average deviation from it, which gives the band of the distances
+ * matching it. The first BACKGROUND_LEARN distances are averaged evenly, then
+ * only the ones matching the background are, with BACKGROUND_WEIGHT, so that
+ * a passing object does not move it. An object staying still long enough
+ * becomes the background. Values are kept with 4 fractional bits.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "background.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define BACKGROUND_SHIFT    (4)     // Fractional bits of the distances
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Background of a bearing.
+ */
+typedef struct BACKGROUND_STRUCT
+{
+    long_int_t  average;        // Average distance in ticks
+    long_int_t  spread;         // Average deviation from it
+    uint8_t     seen;           // Distances averaged, up to BACKGROUND_LEARN
+    uint8_t     outside;        // Distances out of the band in a row
+    bool_t      hidden;         // Whether the last distance matched it
+} background_t;
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static background_t background_states[BACKGROUND_BEARINGS];
+static bool_t       background_suppress = BACKGROUND_SUPPRESS_DEFAULT;
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Returns the half width of the band of the distances matching a background,
+ * with its fractional bits.
+ */
+long_int_t background_band(const background_t* state)
+{
+    return BACKGROUND_SPREADS * state->spread +
+            (STATIC_CAST(long_int_t, BACKGROUND_BAND_MIN) << BACKGROUND_SHIFT);
+}
+
+/*
+ * Moves the average and the deviation of a background towards a distance by
+ * the given Q16 weight.
+ */
+void background_learn(background_t* state, long_int_t distance, q16_t weight)
+{
+    long_int_t deviation = distance - state->average;
+
+    if(deviation < 0)
+        deviation = -deviation;
+
+    state->average += Q16_MUL(distance - state->average, weight);
+    state->spread += Q16_MUL(deviation - state->spread, weight);
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets all the backgrounds, see background.h.
+ */
+void background_init()
+{
+    int_t i;
+
+    for(i = 0; i < BACKGROUND_BEARINGS; ++i)
+    {
+        background_states[i].seen = 0;
+        background_states[i].hidden = false;
+    }
+
+    background_suppress = BACKGROUND_SUPPRESS_DEFAULT;
+}
+
+/*
+ * Compares a distance with the background and learns it, see background.h.
+ */
+bool_t background_update(int_t pos, distance_t distance)
+{
+    background_t*   state;
+    long_int_t      value;
+    long_int_t      deviation;
+
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return true;
+
+    state = &background_states[pos - USR_MIN_POS];
+    value = STATIC_CAST(long_int_t, distance) << BACKGROUND_SHIFT;
+
+    if(state->seen == 0)
+    {
+        state->average = value;
+        state->spread = 0;
+        state->outside = 0;
+    }
+
+    // Still learning, everything is shown
+    if(state->seen < BACKGROUND_LEARN)
+    {
+        ++state->seen;
+        background_learn(state, value, Q16_ONE / state->seen);
+        state->hidden = false;
+
+        return true;
+    }
+
+    deviation = value - state->average;
+    state->hidden = BOOL(deviation <= background_band(state) &&
+            deviation >= -background_band(state));
+
+    if(state->hidden)
+    {
+        state->outside = 0;
+        background_learn(state, value, BACKGROUND_WEIGHT);
+    } else if(++state->outside >= BACKGROUND_ABSORB)
+    {
+        // The scene changed, the object staying there is the new background
+        state->average = value;
+        state->spread = 0;
+        state->outside = 0;
+    }
+
+    return !state->hidden;
+}
+
+/*
+ * Copies the background at a position, see background.h.
+ */
+bool_t background_get(int_t pos, distance_t* distance, distance_t* band)
+{
+    const background_t* state;
+
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return false;
+
+    state = &background_states[pos - USR_MIN_POS];
+
+    if(state->seen < BACKGROUND_LEARN)
+        return false;
+
+    *distance = STATIC_CAST(distance_t,
+            (state->average + (1L << (BACKGROUND_SHIFT - 1))) >> BACKGROUND_SHIFT);
+    *band = STATIC_CAST(distance_t, background_band(state) >> BACKGROUND_SHIFT);
+
+    return true;
+}
+
+/*
+ * Sets whether the background is hidden.
+ */
+void background_set_suppress(bool_t suppress)
+{
+    background_suppress = suppress;
+}
+
+/*
+ * Tells whether the last distance at a position is hidden, see background.h.
+ */
+bool_t background_hides(int_t pos)
+{
+    if(!background_suppress || pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return false;
+
+    return background_states[pos - USR_MIN_POS].hidden;
+}
@@ -0,0 +1,91 @@
+/*
+ * background.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the background.c file.
+ *
+ * */
+
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include "types.h"
+#include "fixed.h"
+#include "motor.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define BACKGROUND_BEARINGS (USR_MAX_POS + 1)
+                                    // Motor positions with their own model
+
+#define BACKGROUND_LEARN    (16)    // Visits averaged before the background
+                                    // of a bearing is known
+#define BACKGROUND_WEIGHT   Q16(1.0 / 32)
+                                    // Weight of a new distance once known,
+                                    // so that the background follows slowly
+
+#define BACKGROUND_SPREADS  (4)     // Half width of the band of distances
+                                    // matching the background, in average
+                                    // deviations, about 3 standard ones
+#define BACKGROUND_BAND_US  (300)   // Narrowest half band, about 5 cm, in
+                                    // microseconds of echo
+#define BACKGROUND_BAND_MIN (BACKGROUND_BAND_US / DISTANCE_PERIOD)
+
+#define BACKGROUND_ABSORB   (32)    // Visits in a row out of the band after
+                                    // which the distance is the background,
+                                    // as the scene changed
+
+/*
+ * Whether the distances matching the background are hidden by default.
+ * Defining __BACKGROUND_SUPPRESS__ shows only the foreground, for fixed
+ * installations.
+ */
+#if defined(__BACKGROUND_SUPPRESS__)
+#define BACKGROUND_SUPPRESS_DEFAULT true
+#else
+#define BACKGROUND_SUPPRESS_DEFAULT false
+#endif
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets the background of all the bearings and sets the default
+ * suppression.
+ */
+extern void background_init();
+
+/*
+ * Compares the distance measured at the given motor position with the
+ * background there, then learns it. Returns true if it is in the foreground,
+ * as all the distances are until the background is known. SENSOR_DIST_MAX,
+ * nothing in sight, can be the background too. Positions out of
+ * USR_MIN_POS..USR_MAX_POS are always in the foreground.
+ */
+extern bool_t background_update(int_t pos, distance_t distance);
+
+/*
+ * Copies the background distance at the given motor position and the half
+ * width of the band of distances matching it, in ticks. Returns false if it
+ * is not known yet.
+ */
+extern bool_t background_get(int_t pos, distance_t* distance, distance_t* band);
+
+/*
+ * Sets whether the distances matching the background are hidden.
+ */
+extern void background_set_suppress(bool_t suppress);
+
+/*
+ * Tells whether the last distance measured at the given motor position shall
+ * be hidden, as it matched the background and suppression is on.
+ */
+extern bool_t background_hides(int_t pos);
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * calib.c
+ *
+ * This file contains the calibration of the sensors latency and gain, fitted
+ * to echoes of objects at known distances.
+ *
+ * Each expected duration y is modelled as gain * (x - offset), where x is the
+ * measured one. A least squares line y = a * x + b gives gain = a and
+ * offset = -b / a, all computed in integer arithmetic on 64 bit sums.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "calib.h"
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Divides rounding to the nearest integer, the divisor shall be positive.
+ */
+int64_t div_round(int64_t num, int64_t den)
+{
+    return num >= 0 ? (num + den / 2) / den : (num - den / 2) / den;
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Removes all the measures, see calib.h.
+ */
+void calib_init(calib_t* calib)
+{
+    calib->count  = 0;
+    calib->sum_x  = 0;
+    calib->sum_y  = 0;
+    calib->sum_xx = 0;
+    calib->sum_xy = 0;
+    calib->first_y = 0;
+    calib->spread = false;
+}
+
+/*
+ * Adds a measure of a known distance, see calib.h.
+ */
+void calib_add(calib_t* calib, stamp_t measured, stamp_t expected)
+{
+    int64_t x = measured;
+    int64_t y = expected;
+
+    if(calib->count >= CALIB_POINTS_MAX ||
+            measured > CALIB_US_MAX || expected > CALIB_US_MAX)
+        return;
+
+    if(calib->count == 0)
+        calib->first_y = expected;
+    else if(expected != calib->first_y)
+        calib->spread = true;
+
+    ++calib->count;
+
+    calib->sum_x  += x;
+    calib->sum_y  += y;
+    calib->sum_xx += x * x;
+    calib->sum_xy += x * y;
+}
+
+/*
+ * Fits the calibration to the measures, see calib.h.
+ */
+bool_t calib_fit(const calib_t* calib, sensor_calib_t* result)
+{
+    int64_t n = calib->count;
+    int64_t den;
+    int64_t gain;
+    int64_t offset;
+
+    if(n == 0)
+        return false;
+
+    den = n * calib->sum_xx - calib->sum_x * calib->sum_x;
+
+    // The gain needs at least two different distances, the noise of the
+    // measures of a single one would give a meaningless slope
+    if(calib->spread && den > 0)
+        gain = div_round((n * calib->sum_xy - calib->sum_x * calib->sum_y)
+                << SENSOR_CALIB_SHIFT, den);
+    else
+        gain = SENSOR_CALIB_UNIT;
+
+    if(gain < SENSOR_CALIB_UNIT / 2 || gain > SENSOR_CALIB_UNIT * 2)
+        return false;
+
+    // Mean of the measures minus the mean of the expectations over the gain
+    offset = div_round(calib->sum_x * gain -
+            (calib->sum_y << SENSOR_CALIB_SHIFT), n * gain);
+
+    result->gain   = STATIC_CAST(uint_t, gain);
+    result->offset = STATIC_CAST(int_t, offset);
+
+    return true;
+}
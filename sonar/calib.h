@@ -0,0 +1,75 @@
+/*
+ * calib.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the calib.c file.
+ *
+ * */
+
+#ifndef CALIB_H
+#define CALIB_H
+
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define CALIB_POINTS_MAX    (256)   // Largest number of measures fitted, so
+                                    // that the sums never overflow
+#define CALIB_US_MAX        SENSOR_CALIB_US_MAX
+                                    // Longest duration of a measure fitted
+
+// Converts a distance in cm to the duration in microseconds of its echo, at
+// the speed of sound in use
+#define CALIB_CM_TO_US(cm) SOUND_MM_TO_US(STATIC_CAST(uint32_t,cm) * 10)
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Contains the sums needed to fit a calibration to the measures added so
+ * far, so that no measure has to be stored.
+ */
+typedef struct CALIB_STRUCT
+{
+    int_t       count;          // Number of measures added
+    int64_t     sum_x;          // Sum of the measured durations
+    int64_t     sum_y;          // Sum of the expected durations
+    int64_t     sum_xx;         // Sum of the squared measured durations
+    int64_t     sum_xy;         // Sum of the products of the durations
+    stamp_t     first_y;        // Expected duration of the first measure
+    bool_t      spread;         // Whether the measures are of more distances
+} calib_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Removes all the measures added so far.
+ */
+extern void calib_init(calib_t* calib);
+
+/*
+ * Adds the duration in microseconds measured by a sensor (see
+ * sensors_get_raw_width) for an object whose echo is expected to last the
+ * given microseconds (see CALIB_CM_TO_US). Measures after CALIB_POINTS_MAX or
+ * longer than CALIB_US_MAX are ignored.
+ */
+extern void calib_add(calib_t* calib, stamp_t measured, stamp_t expected);
+
+/*
+ * Fits the calibration of a sensor to the measures added so far, by least
+ * squares. With measures of a single distance only the offset is fitted.
+ * Returns false if there are no measures or the fitted gain is not between
+ * half and twice SENSOR_CALIB_UNIT.
+ */
+extern bool_t calib_fit(const calib_t* calib, sensor_calib_t* result);
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * capture.c
+ *
+ * This file contains the input capture backend used to measure the echo
+ * signals. A 32 bit timer runs freely at 1 MHz and each edge on an echo line is
+ * timestamped with its counter, then forwarded to the sensor module, so that
+ * the systick handler does not need to poll the echo pins anymore.
+ *
+ * The left echo pin (PA5) is the channel 1 of TIM2, so its edges are latched by
+ * the timer itself. The right echo pin (PB13) is not connected to any channel
+ * of TIM2, so its edges are timestamped by reading the counter from the
+ * external interrupt handler, adding only the interrupt latency.
+ *
+ * The echo ports and pins are the ones of sensor_config.c, the timer channel
+ * and the external interrupt line below shall be the ones of those pins. The
+ * interrupt handlers are declared in conf.oil for all the backends, but the
+ * interrupts are enabled only when SENSOR_ACQ_MODE is SENSOR_ACQ_CAPTURE.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "ee.h"
+
+#include "lib/tm_stm32f4_gpio.h"
+#include "lib/tm_stm32f4_timer_properties.h"
+
+#include "stm32f4xx_exti.h"
+#include "stm32f4xx_syscfg.h"
+
+#include "sensor.h"
+#include "sensor_config.h"
+#include "capture.h"
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_CAPTURE
+
+#if SENSORS_NUM != 2
+#error "The capture backend handles only the left and the right sensor"
+#endif
+
+/* ---------------------------
+ * Private constants
+ * ---------------------------
+ */
+
+#define CAPTURE_TIMER       (TIM2)      // 32 bit timer used as time base
+#define CAPTURE_TIMER_IRQ   (TIM2_IRQn)
+#define CAPTURE_FREQUENCY   (1000000)   // One timer tick each microsecond
+
+// Left echo, captured by the timer channel
+#define CAPTURE_LX_AF       (GPIO_AF_TIM2)
+#define CAPTURE_LX_CHANNEL  (TIM_Channel_1)
+#define CAPTURE_LX_IT       (TIM_IT_CC1)
+
+// Right echo, timestamped from the external interrupt
+#define CAPTURE_RX_PORT_SRC (EXTI_PortSourceGPIOB)
+#define CAPTURE_RX_PIN_SRC  (EXTI_PinSource13)
+#define CAPTURE_RX_LINE     (EXTI_Line13)
+#define CAPTURE_RX_IRQ      (EXTI15_10_IRQn)
+
+#define CAPTURE_FILTER      (0x3)       // Input filter, 8 samples at fCK_INT
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Configures the timer as a free running 1 MHz counter and its first channel
+ * to capture both edges of the left echo.
+ */
+void capture_timer_init()
+{
+    TM_TIMER_PROPERTIES_t   timer_data;
+    TIM_TimeBaseInitTypeDef base_struct;
+    TIM_ICInitTypeDef       ic_struct;
+
+    TM_TIMER_PROPERTIES_EnableClock(CAPTURE_TIMER);
+    TM_TIMER_PROPERTIES_GetTimerProperties(CAPTURE_TIMER, &timer_data);
+
+    base_struct.TIM_Prescaler = timer_data.TimerFrequency / CAPTURE_FREQUENCY - 1;
+    base_struct.TIM_CounterMode = TIM_CounterMode_Up;
+    base_struct.TIM_Period = 0xFFFFFFFF;
+    base_struct.TIM_ClockDivision = TIM_CKD_DIV1;
+    base_struct.TIM_RepetitionCounter = 0;
+
+    TIM_TimeBaseInit(CAPTURE_TIMER, &base_struct);
+
+    TM_GPIO_InitAlternate(sensor_pins[SENSOR_LX].echo_port,
+                sensor_pins[SENSOR_LX].echo_pin,
+                TM_GPIO_OType_PP,
+                TM_GPIO_PuPd_NOPULL,
+                TM_GPIO_Speed_High,
+                CAPTURE_LX_AF);
+
+    ic_struct.TIM_Channel = CAPTURE_LX_CHANNEL;
+    ic_struct.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    ic_struct.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    ic_struct.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    ic_struct.TIM_ICFilter = CAPTURE_FILTER;
+
+    TIM_ICInit(CAPTURE_TIMER, &ic_struct);
+
+    TIM_ITConfig(CAPTURE_TIMER, CAPTURE_LX_IT, ENABLE);
+    NVIC_EnableIRQ(CAPTURE_TIMER_IRQ);
+
+    TIM_Cmd(CAPTURE_TIMER, ENABLE);
+}
+
+/*
+ * Configures the external interrupt on both edges of the right echo.
+ */
+void capture_exti_init()
+{
+    EXTI_InitTypeDef exti_struct;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+    SYSCFG_EXTILineConfig(CAPTURE_RX_PORT_SRC, CAPTURE_RX_PIN_SRC);
+
+    exti_struct.EXTI_Line = CAPTURE_RX_LINE;
+    exti_struct.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti_struct.EXTI_Trigger = EXTI_Trigger_Rising_Falling;
+    exti_struct.EXTI_LineCmd = ENABLE;
+
+    EXTI_Init(&exti_struct);
+
+    NVIC_EnableIRQ(CAPTURE_RX_IRQ);
+}
+
+#endif
+
+/* ---------------------------
+ * Interrupt handlers
+ * ---------------------------
+ */
+
+/*
+ * Forwards the edge latched by the timer channel to the sensor module.
+ */
+ISR2(capture_timer_handler)
+{
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_CAPTURE
+    stamp_t stamp;
+    bool_t  level;
+
+    if(TIM_GetITStatus(CAPTURE_TIMER, CAPTURE_LX_IT) == RESET)
+        return;
+
+    // Reading the captured value also clears the interrupt flag
+    stamp = TIM_GetCapture1(CAPTURE_TIMER);
+    level = BOOL(TM_GPIO_GetInputPinValue(sensor_pins[SENSOR_LX].echo_port,
+            sensor_pins[SENSOR_LX].echo_pin));
+
+    sensors_echo_edge(SENSOR_LX, level, stamp);
+#endif
+}
+
+/*
+ * Timestamps the edge seen by the external interrupt and forwards it to the
+ * sensor module.
+ */
+ISR2(capture_exti_handler)
+{
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_CAPTURE
+    stamp_t stamp;
+    bool_t  level;
+
+    // The counter is read first, to keep the latency as low as possible
+    stamp = TIM_GetCounter(CAPTURE_TIMER);
+
+    if(EXTI_GetITStatus(CAPTURE_RX_LINE) == RESET)
+        return;
+
+    EXTI_ClearITPendingBit(CAPTURE_RX_LINE);
+    level = BOOL(TM_GPIO_GetInputPinValue(sensor_pins[SENSOR_RX].echo_port,
+            sensor_pins[SENSOR_RX].echo_pin));
+
+    sensors_echo_edge(SENSOR_RX, level, stamp);
+#endif
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Starts the capture timer and enables the interrupts on both echo lines.
+ * From now on each edge is forwarded to sensors_echo_edge.
+ */
+void capture_init()
+{
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_CAPTURE
+    capture_timer_init();
+    capture_exti_init();
+#endif
+}
@@ -0,0 +1,27 @@
+/*
+ * capture.h
+ *
+ * This file contains all declaration of public functions defined in the
+ * capture.c file.
+ *
+ * */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Starts the capture timer and enables the interrupts on both echo lines.
+ * From now on each edge is forwarded to sensors_echo_edge. Does nothing
+ * unless SENSOR_ACQ_MODE is SENSOR_ACQ_CAPTURE.
+ */
+extern void capture_init();
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * change.c
+ *
+ * This file contains the detection of the bearings whose distance changed
+ * since the previous sweep, such as for an intruder. Each distance is compared
+ * only with the last one measured at its bearing, and the bitmap of the
+ * changed bearings and their number are updated with it, in constant time.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "change.h"
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static distance_t   change_distances[CHANGE_BEARINGS];
+                                // Distance of the last visit of each bearing
+static uint32_t     change_visited[CHANGE_WORDS];
+                                // Bearings with a distance to compare with
+static uint32_t     change_bitmap[CHANGE_WORDS];
+static int_t        change_changed = 0;
+                                // Bits set in change_bitmap
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets all the distances, see change.h.
+ */
+void change_init()
+{
+    int_t i;
+
+    for(i = 0; i < CHANGE_WORDS; ++i)
+    {
+        change_visited[i] = 0;
+        change_bitmap[i] = 0;
+    }
+
+    change_changed = 0;
+}
+
+/*
+ * Compares a distance with the last one at its bearing, see change.h.
+ */
+bool_t change_update(int_t pos, distance_t distance)
+{
+    uint32_t*   word;
+    uint32_t    bit;
+    long_int_t  diff;
+    bool_t      changed;
+
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return false;
+
+    pos -= USR_MIN_POS;
+    word = &change_bitmap[pos / 32];
+    bit = 1UL << (pos % 32);
+
+    if(!(change_visited[pos / 32] & bit))
+        changed = false;
+    else if(distance >= SENSOR_DIST_MAX || change_distances[pos] >= SENSOR_DIST_MAX)
+        changed = BOOL(distance != change_distances[pos]);
+    else
+    {
+        diff = STATIC_CAST(long_int_t, distance) - change_distances[pos];
+        changed = BOOL(diff >= CHANGE_MIN || diff <= -CHANGE_MIN);
+    }
+
+    if(changed && !(*word & bit))
+        ++change_changed;
+    else if(!changed && (*word & bit))
+        --change_changed;
+
+    *word = changed ? *word | bit : *word & ~bit;
+
+    change_visited[pos / 32] |= bit;
+    change_distances[pos] = distance;
+
+    return changed;
+}
+
+/*
+ * Copies the changed bearings, see change.h.
+ */
+int_t change_get_bitmap(uint32_t bitmap[CHANGE_WORDS])
+{
+    int_t i;
+
+    for(i = 0; i < CHANGE_WORDS; ++i)
+        bitmap[i] = change_bitmap[i];
+
+    return change_changed;
+}
+
+/*
+ * Returns the number of changed bearings.
+ */
+int_t change_count()
+{
+    return change_changed;
+}
@@ -0,0 +1,70 @@
+/*
+ * change.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the change.c file.
+ *
+ * */
+
+#ifndef CHANGE_H
+#define CHANGE_H
+
+#include "types.h"
+#include "motor.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define CHANGE_BEARINGS     (USR_MAX_POS + 1)
+                                    // Motor positions watched
+
+#define CHANGE_WORDS        ((CHANGE_BEARINGS + 31) / 32)
+                                    // Words of the changed bearings bitmap
+
+#define CHANGE_US           (1200)  // Smallest change of the distance at a
+                                    // bearing since its last visit flagged,
+                                    // about 20 cm, in microseconds of echo
+#define CHANGE_MIN          (CHANGE_US / DISTANCE_PERIOD)
+
+/*
+ * Tells whether the bit of a position, from USR_MIN_POS, is set in a bitmap
+ * of CHANGE_WORDS words.
+ */
+#define CHANGE_BIT(bitmap, pos) \
+    BOOL((bitmap)[((pos) - USR_MIN_POS) / 32] & (1UL << (((pos) - USR_MIN_POS) % 32)))
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets the distances of all the bearings, so that the next visit of each
+ * one is not compared.
+ */
+extern void change_init();
+
+/*
+ * Compares the distance measured at the given motor position with the one of
+ * its last visit, setting its bit in the changed bearings if they differ by
+ * CHANGE_MIN or more, clearing it otherwise. SENSOR_DIST_MAX, nothing in
+ * sight, is a change from any object. Returns whether it changed, false for
+ * positions out of USR_MIN_POS..USR_MAX_POS.
+ */
+extern bool_t change_update(int_t pos, distance_t distance);
+
+/*
+ * Copies the bitmap of the changed bearings, see CHANGE_BIT, and returns their
+ * number.
+ */
+extern int_t change_get_bitmap(uint32_t bitmap[CHANGE_WORDS]);
+
+/*
+ * Returns the number of changed bearings.
+ */
+extern int_t change_count();
+
+#endif
@@ -15,6 +15,15 @@
 
 #include "motor.h"
 #include "sensor.h"
+#include "tracker.h"
+#include "grid.h"
+#include "segment.h"
+#include "change.h"
+#include "background.h"
+#include "nearest.h"
+#include "sampler.h"
+#include "thermo.h"
+#include "sound.h"
 #include "gui.h"
 
 /* ---------------------------
@@ -23,15 +32,96 @@
  */
 
 static bool_t   started = false;
+static bool_t   step_pending = false;
+                                // Whether TaskStep was activated by the systick
+                                // handler and did not send the trigger yet
 
 ISR2(systick_handler)
 {
     CounterTick(sysCount);
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_POLLING
+    // With the capture backend echo edges are timestamped by capture.c
     if(started)
+    {
         sensors_read();
+
+#if STEP_MODE == STEP_MODE_ADAPTIVE
+        // The next step starts as soon as all echoes are done and the servo
+        // reached its position, see sensors_step_ready
+        if(!step_pending && sensors_step_ready())
+        {
+            step_pending = true;
+            ActivateTask(TaskStep);
+        }
+#endif
+    }
+#endif
+}
+
+
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Shows the further echoes captured by each sensor for the last trigger at the
+ * given position, the first ones are already in the measured distance. None
+ * is shown where the background is hidden.
+ */
+void show_returns(int_t pos)
+{
+    returns_t   returns;
+    int_t       distances[SENSORS_NUM * (SENSOR_RETURNS_MAX - 1)];
+    int_t       count = 0;
+    int_t       i;
+    int_t       j;
+
+    for(i = 0; i < SENSORS_NUM && !background_hides(pos); ++i)
+    {
+        if(!sensors_get_returns(i, &returns))
+            continue;
+
+        for(j = 1; j < returns.num; ++j)
+            distances[count++] = DISTANCE_TO_MM(RETURN_DISTANCE(returns.echoes[j]));
+    }
+
+    gui_set_returns(pos, distances, count);
+}
+
+/*
+ * Shows the obstacle predicted at the given time at a position, nothing where
+ * no object is tracked or the background is hidden. The tracks are the only
+ * source of the obstacles on the screen: they follow the distances past the
+ * median and gate filters, so those still remove the spurious echoes from the
+ * display, see filter_get_robust.
+ */
+void show_track(int_t pos, stamp_t now)
+{
+    track_t track;
+
+    tracker_get(pos, now, &track);
+
+    if(background_hides(pos))
+        track.range = SENSOR_DIST_MAX;
+
+    gui_set_obstacle(pos, DISTANCE_TO_MM(track.range));
 }
 
+/*
+ * Shows the obstacles predicted now at all the positions, instead of the ones
+ * measured up to a sweep ago.
+ */
+void show_tracks()
+{
+    const stamp_t   now = sensors_get_time();
+    int_t           pos;
 
+    for(pos = USR_MIN_POS; pos <= USR_MAX_POS; ++pos)
+        show_track(pos, now);
+}
 
 /* ---------------------------
  * Tasks
@@ -40,49 +130,92 @@ ISR2(systick_handler)
 
 /*
  * This task is executed each time the radar needs to move to a new position.
- * It tells the motor to move and sends a new trigger signal to both sensors.
+ * It tells the motor to move and sends a new trigger signal to both sensors,
+ * then adds the distance measured at the previous position to the map and to
+ * the objects, compares it with the one of the previous sweep and with the
+ * background, sets it for the nearest object search, and shows the track it
+ * corrected.
  */
 TASK(TaskStep)
 {
-    int_t   dist;
-    int_t   pos;
+    distance_t  distance;
+    distance_t  measured;
+    int_t       pos;
 
     TM_DISCO_LedToggle(LED_RED);
 
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_DMA
+    // Edges sampled so far must be seen before closing the listening window,
+    // the sampler task has higher priority so it runs immediately
+    ActivateTask(TaskSampler);
+#endif
+
     pos = motor_get_pos();
 
     if(started)
     {
         motor_step();
+        sensors_set_bearing(motor_get_pos());
         sensors_send_trigger();
 
-        dist = DISTANCE_TO_CM(sensors_get_last_distance());
+        distance = sensors_get_last_distance();
+        measured = sensors_get_last_measured();
+
+        grid_update(pos, distance);
+        segment_update(pos, distance);
+
+        // The filters would spread a change over several sweeps
+        change_update(pos, measured);
+        background_update(pos, measured);
+        nearest_update(pos, distance);
 
-        gui_set_position(pos, dist);
+        gui_set_position(pos);
+        show_track(pos, sensors_get_time());
+        show_returns(pos);
     } else
     {
         started = true;
+        sensors_set_bearing(pos);
         sensors_send_trigger();
     }
+
+#if STEP_MODE == STEP_MODE_ADAPTIVE
+    step_pending = false;
+#endif
 }
 
 /*
- * This task is executed only to stop sending the trigger signal to sensors.
+ * This task is executed to scan the echo samples copied by the DMA since its
+ * last activation.
  */
-TASK(TaskStopTrigger)
+TASK(TaskSampler)
 {
-    sensors_stop_trigger();
+    sampler_process();
 }
 
 /*
- * This task is executed to refresh the screen content. It also checks if the
- * user pressed the button and notifies the gui module to change zoom level.
+ * This task is executed to refresh the screen content with the obstacles
+ * predicted at all the positions. It also checks if the user pressed the
+ * button and notifies the gui module to change zoom level, and follows the
+ * temperature with the speed of sound.
  */
 TASK(TaskGui)
 {
+    sound_update();
+
+    // TaskStep corrects the tracks and must not preempt their prediction
+    GetResource(TrackerResource);
+    show_tracks();
+    ReleaseResource(TrackerResource);
+
     if(TM_DISCO_ButtonOnPressed())
+    {
         gui_change_zoom_level();
 
+        // Echoes beyond the screen are not waited for
+        sensors_set_range(CM_TO_DISTANCE(gui_get_max_distance()));
+    }
+
     gui_refresh();
 }
 
@@ -137,6 +270,13 @@ int main(void) {
     // Initialize all the program modules
     gui_init();
     sensors_init();
+    grid_init();
+    segment_init();
+    change_init();
+    background_init();
+    nearest_init();
+    thermo_init();
+    sound_update();
 
     // Initialize motor for calibration and wait the calibration to finish
     motor_init(MOTOR_MID, LEFT);
@@ -145,12 +285,21 @@ int main(void) {
     // Move the motor to the initial position and initialize interface
     motor_set_pos(USR_MIN_POS);
     gui_interface_init();
+    sensors_set_range(CM_TO_DISTANCE(gui_get_max_distance()));
 
     // Set alarms to trigger tasks activation
+#if STEP_MODE == STEP_MODE_ADAPTIVE
+    // Only the first step is activated by the alarm, see systick_handler
+    SetRelAlarm(AlarmStep, 100, 0);
+#else
     SetRelAlarm(AlarmStep, 100, STEP_PERIOD_TICKS);
-    SetRelAlarm(AlarmStopTrigger, 110, STEP_PERIOD_TICKS);
+#endif
     SetRelAlarm(AlarmGui, 50, SCREEN_PERIOD_TICKS);
 
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_DMA
+    SetRelAlarm(AlarmSampler, SAMPLER_TASK_PERIOD_TICKS, SAMPLER_TASK_PERIOD_TICKS);
+#endif
+
     // Forever loop
     while (1) {}
 }
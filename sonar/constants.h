@@ -2,6 +2,7 @@
 #define CONST_H
 
 #include "types.h"
+#include "motor.h"
 
 #define SOFTWARE_VERSION    "1.0 beta"
 
@@ -28,4 +29,80 @@
 #define SCREEN_PERIOD_TICKS (SCREEN_PERIOD / SYST_PERIOD)
                             // Defines the interval in number of ticks between
                             // one screen refresh and the following one
+
+/* -----------------------------------------------------------------------------
+ * Echo acquisition backends
+ *
+ * The backend is chosen at build time by defining one of the following symbols
+ * (e.g. with an EE_OPT in conf.oil), by default echo pins are polled.
+ * -----------------------------------------------------------------------------
+ */
+
+#define SENSOR_ACQ_POLLING  (0) // Echo pins are polled by the systick handler
+                                // every SYST_PERIOD microseconds
+#define SENSOR_ACQ_CAPTURE  (1) // Echo edges are timestamped by a hardware
+                                // timer, see capture.c
+#define SENSOR_ACQ_DMA      (2) // Echo ports are copied by the DMA into a
+                                // buffer, scanned by a task, see sampler.c
+
+#if defined(__SENSOR_ACQ_CAPTURE__)
+#define SENSOR_ACQ_MODE     SENSOR_ACQ_CAPTURE
+#elif defined(__SENSOR_ACQ_DMA__)
+#define SENSOR_ACQ_MODE     SENSOR_ACQ_DMA
+#else
+#define SENSOR_ACQ_MODE     SENSOR_ACQ_POLLING
+#endif
+
+/*
+ * When polling, echo pins can be sampled either on every systick or only while
+ * the sensors are listening for an echo, see sensors_set_sampling.
+ */
+
+#define SENSOR_SAMPLING_ALWAYS  (0) // Sample on every systick
+#define SENSOR_SAMPLING_GATED   (1) // Sample from the trigger until both
+                                    // echoes finished or timed out
+
+#if defined(__SENSOR_SAMPLING_GATED__)
+#define SENSOR_SAMPLING_MODE    SENSOR_SAMPLING_GATED
+#else
+#define SENSOR_SAMPLING_MODE    SENSOR_SAMPLING_ALWAYS
+#endif
+
+/* -----------------------------------------------------------------------------
+ * Pulse repetition
+ *
+ * By default a new step starts every STEP_PERIOD microseconds. Defining
+ * __STEP_ADAPTIVE__ starts it as soon as all echoes completed or timed out and
+ * STEP_GUARD microseconds passed, but not before STEP_MIN microseconds since
+ * the previous one, STEP_PERIOD is then only the upper bound.
+ * -----------------------------------------------------------------------------
+ */
+
+#define STEP_MODE_FIXED     (0) // Steps are activated by a periodic alarm
+#define STEP_MODE_ADAPTIVE  (1) // Steps are activated by the systick handler,
+                                // see sensors_step_ready
+
+#if defined(__STEP_ADAPTIVE__)
+#define STEP_MODE           STEP_MODE_ADAPTIVE
+#else
+#define STEP_MODE           STEP_MODE_FIXED
+#endif
+
+#if STEP_MODE == STEP_MODE_ADAPTIVE && SENSOR_ACQ_MODE != SENSOR_ACQ_POLLING
+#error "Adaptive steps need the echo pins to be polled by the systick handler"
+#endif
+
+#define STEP_GUARD      (5000)
+                            // Defines the interval in microseconds between
+                            // the end of the listening window and the next
+                            // trigger, letting the transducers ring down, must
+                            // be an integer multiple of SYST_PERIOD
+
+#define STEP_MIN        (MOTOR_SETTLE_US)
+                            // Defines the shortest interval in microseconds
+                            // between two adaptive steps, so that the servo
+                            // reached each position before the next one is
+                            // commanded, must be an integer multiple of
+                            // SYST_PERIOD
+
 #endif
@@ -0,0 +1,44 @@
+/*
+ * echo_fsm.c
+ *
+ * This file contains the transition table of the state machine followed by
+ * each sensor at every trigger, see sensor_echo_state_t.
+ *
+ * The table is generated at build time from the ECHO_FSM_NEXT rules, so that
+ * at run time a sensor moves to its next state with a single lookup.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "echo_fsm.h"
+
+/* ---------------------------
+ * Private macros
+ * ---------------------------
+ */
+
+// All the transitions from the given state, in ECHO_FSM_INPUT order
+#define ECHO_FSM_ROW(state)                 \
+    {                                       \
+        ECHO_FSM_NEXT(state, false, false), \
+        ECHO_FSM_NEXT(state, false, true),  \
+        ECHO_FSM_NEXT(state, true, false),  \
+        ECHO_FSM_NEXT(state, true, true),   \
+    }
+
+/* ---------------------------
+ * Globals
+ * ---------------------------
+ */
+
+const uint8_t echo_fsm[SENSOR_ECHO_STATES][ECHO_FSM_INPUTS] =
+{
+    [SENSOR_ECHO_NEXT_OK]   = ECHO_FSM_ROW(SENSOR_ECHO_NEXT_OK),
+    [SENSOR_ECHO_OK]        = ECHO_FSM_ROW(SENSOR_ECHO_OK),
+    [SENSOR_ECHO_LOST]      = ECHO_FSM_ROW(SENSOR_ECHO_LOST),
+    [SENSOR_ECHO_LONG]      = ECHO_FSM_ROW(SENSOR_ECHO_LONG),
+};
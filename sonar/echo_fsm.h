@@ -0,0 +1,70 @@
+/*
+ * echo_fsm.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the echo_fsm.c file.
+ *
+ * */
+
+#ifndef ECHO_FSM_H
+#define ECHO_FSM_H
+
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define ECHO_FSM_INPUTS (4) // Number of possible inputs, see ECHO_FSM_INPUT
+
+/* ---------------------------
+ * Macros
+ * ---------------------------
+ */
+
+/*
+ * Input of the echo state machine, sampled when a new trigger is about to be
+ * sent: whether the sensor is still recording an echo and whether it is still
+ * waiting for the echo of the last trigger.
+ */
+#define ECHO_FSM_INPUT(recording, trig_sent) \
+    ((BOOL(recording) << 1) | BOOL(trig_sent))
+
+/*
+ * Next state of a sensor given its current state and its inputs. A sensor in
+ * the SENSOR_ECHO_LONG state received no trigger, so it cannot be waiting for
+ * an echo. This is a constant expression, used to generate the echo_fsm table
+ * at build time.
+ */
+#define ECHO_FSM_NEXT(state, recording, trig_sent)                          \
+    ((recording) ? SENSOR_ECHO_LONG :                                       \
+     (state) == SENSOR_ECHO_LONG ? SENSOR_ECHO_NEXT_OK :                    \
+     (trig_sent) ? SENSOR_ECHO_LOST : SENSOR_ECHO_OK)
+
+/*
+ * Output of the echo state machine: whether a sensor in the given state is
+ * triggered again, that is it is not still busy with a too long echo.
+ */
+#define ECHO_FSM_TRIGGER(state) BOOL((state) != SENSOR_ECHO_LONG)
+
+/*
+ * Moves a sensor in the given state to its next state, by a lookup in the
+ * echo_fsm table.
+ */
+#define ECHO_FSM_STEP(state, recording, trig_sent) \
+    STATIC_CAST(sensor_echo_state_t, echo_fsm[state][ECHO_FSM_INPUT(recording, trig_sent)])
+
+/* ---------------------------
+ * Globals
+ * ---------------------------
+ */
+
+/*
+ * Transition table of the echo state machine, indexed by the current state and
+ * by the input given by ECHO_FSM_INPUT.
+ */
+extern const uint8_t echo_fsm[SENSOR_ECHO_STATES][ECHO_FSM_INPUTS];
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * edges.c
+ *
+ * This file contains the functions that detect edges in blocks of samples of a
+ * GPIO port, as stored by the DMA sampler (see sampler.c).
+ *
+ * Echo lines change very rarely compared to the sampling rate, so samples are
+ * checked a block at a time: all the samples of a block are compared at once
+ * with the last value, without branches, and only blocks containing a change
+ * are scanned sample by sample.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "edges.h"
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Returns the lines of the mask that differ from last in at least one of the
+ * given samples.
+ */
+uint16_t block_changes(const uint16_t* samples, uint_t count, uint16_t last, uint16_t mask)
+{
+    uint16_t    changes = 0;
+    uint_t      i;
+
+    for(i = 0; i < count; ++i)
+        changes |= samples[i] ^ last;
+
+    return changes & mask;
+}
+
+/*
+ * Scans a block that contains at least a change sample by sample, calling the
+ * handler for each edge found.
+ */
+void block_scan(edges_t* edges, const uint16_t* samples, uint_t count)
+{
+    uint16_t    changes;
+    uint16_t    pin;
+    uint_t      i;
+
+    for(i = 0; i < count; ++i)
+    {
+        changes = (samples[i] ^ edges->last) & edges->mask;
+        edges->last = samples[i];
+
+        // More lines may change on the same sample
+        while(changes)
+        {
+            pin = changes & -changes;
+            changes &= changes - 1;
+
+            edges->handler(edges->data, pin, BOOL(samples[i] & pin), edges->index + i);
+        }
+    }
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Initializes the edge detection of the given lines of a port, assuming them
+ * low before the first sample.
+ */
+void edges_init(edges_t* edges, uint16_t mask, edge_handler_t handler, void* data)
+{
+    edges->mask = mask;
+    edges->last = 0;
+    edges->index = 0;
+    edges->handler = handler;
+    edges->data = data;
+}
+
+/*
+ * Detects the edges in the given consecutive samples of a port, calling the
+ * handler for each of them in order.
+ */
+void edges_detect(edges_t* edges, const uint16_t* samples, uint_t count)
+{
+    uint_t  len;
+
+    while(count > 0)
+    {
+        len = count < EDGES_BLOCK ? count : EDGES_BLOCK;
+
+        if(block_changes(samples, len, edges->last, edges->mask))
+            block_scan(edges, samples, len);
+        else
+            edges->last = samples[len - 1];
+
+        edges->index += len;
+        samples += len;
+        count -= len;
+    }
+}
+
+/*
+ * Detects the edges in a circular buffer of the given size, from the read
+ * position up to the write position (excluded). Returns the new read position.
+ */
+uint_t edges_detect_ring(edges_t* edges, const uint16_t* ring, uint_t size,
+        uint_t read, uint_t write)
+{
+    if(write < read)
+    {
+        // The writer wrapped around, first process up to the end
+        edges_detect(edges, ring + read, size - read);
+        read = 0;
+    }
+
+    edges_detect(edges, ring + read, write - read);
+
+    return write;
+}
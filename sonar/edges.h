@@ -0,0 +1,69 @@
+/*
+ * edges.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the edges.c file.
+ *
+ * */
+
+#ifndef EDGES_H
+#define EDGES_H
+
+#include "types.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define EDGES_BLOCK (16)    // Number of samples checked at once for changes
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Called for each edge found on a line: pin is the mask of the line, level its
+ * new value and index the number of the sample at which it changed.
+ */
+typedef void (*edge_handler_t)(void* data, uint16_t pin, bool_t level, uint32_t index);
+
+/*
+ * Contains the state of the edge detection on the samples of a port.
+ */
+typedef struct EDGES_STRUCT
+{
+    uint16_t        mask;       // Lines whose edges are detected
+    uint16_t        last;       // Value of the port at the last sample
+    uint32_t        index;      // Number of samples processed so far
+
+    edge_handler_t  handler;    // Called for each edge found
+    void*           data;       // Passed to the handler
+} edges_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Initializes the edge detection of the given lines of a port, assuming them
+ * low before the first sample.
+ */
+extern void edges_init(edges_t* edges, uint16_t mask, edge_handler_t handler, void* data);
+
+/*
+ * Detects the edges in the given consecutive samples of a port, calling the
+ * handler for each of them in order.
+ */
+extern void edges_detect(edges_t* edges, const uint16_t* samples, uint_t count);
+
+/*
+ * Detects the edges in a circular buffer of the given size, from the read
+ * position up to the write position (excluded). Returns the new read position.
+ */
+extern uint_t edges_detect_ring(edges_t* edges, const uint16_t* ring, uint_t size,
+        uint_t read, uint_t write);
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * filter.c
+ *
+ * This file contains the filters of the distances measured at each bearing.
+ * Each motor position keeps its own state, so that the distances of different
+ * bearings are never mixed and obstacles are not smeared over the angles.
+ *
+ * Filters are small fixed point stages, chained in a configurable order: the
+ * output of a stage is the input of the next one. Each stage keeps its state
+ * in its own array, so that the memory it needs is known.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "filter.h"
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * State of the median filter at a bearing.
+ */
+typedef struct FILTER_MEDIAN_STRUCT
+{
+    distance_t  last[3];        // Last distances, in a ring
+    uint8_t     next;           // Position of the next distance in last
+    uint8_t     num;            // Number of distances in last
+} filter_median_t;
+
+/*
+ * State of the moving average at a bearing.
+ */
+typedef struct FILTER_EMA_STRUCT
+{
+    distance_t  average;
+    bool_t      valid;          // Whether a distance was seen
+} filter_ema_t;
+
+/*
+ * State of the gate at a bearing.
+ */
+typedef struct FILTER_GATE_STRUCT
+{
+    distance_t  accepted;       // Last distance let through
+    uint8_t     rejected;       // Changes rejected in a row
+    bool_t      valid;          // Whether a distance was seen
+} filter_gate_t;
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static filter_median_t  filter_medians[FILTER_BEARINGS];
+static filter_ema_t     filter_emas[FILTER_BEARINGS];
+static filter_gate_t    filter_gates[FILTER_BEARINGS];
+
+static distance_t       filter_robust;  // Last distance before the average
+
+static filter_kind_t    filter_chain[FILTER_STAGES_MAX] = FILTER_CHAIN_DEFAULT;
+static int_t            filter_stages =
+        sizeof((filter_kind_t[]) FILTER_CHAIN_DEFAULT) / sizeof(filter_kind_t);
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets the distances seen by all the filters at all the bearings.
+ */
+void filter_clear()
+{
+    int_t i;
+
+    for(i = 0; i < FILTER_BEARINGS; ++i)
+    {
+        filter_medians[i].next = 0;
+        filter_medians[i].num = 0;
+        filter_emas[i].valid = false;
+        filter_gates[i].rejected = 0;
+        filter_gates[i].valid = false;
+    }
+}
+
+/*
+ * Returns the median of the last 3 distances, or the last one until 3 of them
+ * are seen.
+ */
+distance_t filter_median(filter_median_t* state, distance_t distance)
+{
+    distance_t a;
+    distance_t b;
+    distance_t c;
+
+    state->last[state->next] = distance;
+    state->next = state->next == 2 ? 0 : state->next + 1;
+
+    if(state->num < 3)
+        ++state->num;
+
+    if(state->num < 3)
+        return distance;
+
+    a = state->last[0];
+    b = state->last[1];
+    c = state->last[2];
+
+    if(a > b)
+    {
+        distance_t t = a;
+        a = b;
+        b = t;
+    }
+
+    // a <= b, the median is b unless c is below it
+    if(c < b)
+        b = c > a ? c : a;
+
+    return b;
+}
+
+/*
+ * Moves the average towards the distance, starting from the first one.
+ */
+distance_t filter_ema(filter_ema_t* state, distance_t distance)
+{
+    if(!state->valid)
+    {
+        state->average = distance;
+        state->valid = true;
+    } else
+        state->average = STATIC_CAST(distance_t,
+                Q15_BLEND(state->average, distance, FILTER_EMA_WEIGHT));
+
+    return state->average;
+}
+
+/*
+ * Lets the distance through if close to the last one let through, otherwise
+ * repeats that one, up to FILTER_GATE_HOLD times in a row.
+ */
+distance_t filter_gate(filter_gate_t* state, distance_t distance)
+{
+    distance_t change = distance - state->accepted;
+
+    if(state->valid && (change > FILTER_GATE_MAX || change < -FILTER_GATE_MAX) &&
+            state->rejected < FILTER_GATE_HOLD)
+    {
+        ++state->rejected;
+        return state->accepted;
+    }
+
+    state->accepted = distance;
+    state->rejected = 0;
+    state->valid = true;
+
+    return distance;
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Sets the default chain, see filter.h.
+ */
+void filter_init()
+{
+    const filter_kind_t kinds[] = FILTER_CHAIN_DEFAULT;
+
+    filter_set_chain(kinds, sizeof(kinds) / sizeof(kinds[0]));
+}
+
+/*
+ * Sets the chain of filters, see filter.h.
+ */
+bool_t filter_set_chain(const filter_kind_t kinds[], int_t count)
+{
+    int_t i;
+
+    if(count < 0 || count > FILTER_STAGES_MAX)
+        return false;
+
+    for(i = 0; i < count; ++i)
+    {
+        if(kinds[i] < 0 || kinds[i] >= FILTER_KINDS)
+            return false;
+    }
+
+    for(i = 0; i < count; ++i)
+        filter_chain[i] = kinds[i];
+
+    filter_stages = count;
+    filter_clear();
+
+    return true;
+}
+
+/*
+ * Copies the chain of filters, see filter.h.
+ */
+int_t filter_get_chain(filter_kind_t kinds[])
+{
+    int_t i;
+
+    for(i = 0; i < filter_stages; ++i)
+        kinds[i] = filter_chain[i];
+
+    return filter_stages;
+}
+
+/*
+ * Filters a distance with the state of its bearing, see filter.h.
+ */
+distance_t filter_update(int_t bearing, distance_t distance)
+{
+    int_t i;
+
+    filter_robust = distance;
+
+    if(bearing < USR_MIN_POS || bearing > USR_MAX_POS)
+        return distance;
+
+    bearing -= USR_MIN_POS;
+
+    for(i = 0; i < filter_stages; ++i)
+    {
+        switch(filter_chain[i])
+        {
+        case FILTER_MEDIAN:
+            distance = filter_median(&filter_medians[bearing], distance);
+            filter_robust = distance;
+            break;
+        case FILTER_EMA:
+            distance = filter_ema(&filter_emas[bearing], distance);
+            break;
+        case FILTER_GATE:
+            distance = filter_gate(&filter_gates[bearing], distance);
+            filter_robust = distance;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return distance;
+}
+
+/*
+ * Returns the last distance before the average, see filter.h.
+ */
+distance_t filter_get_robust()
+{
+    return filter_robust;
+}
+
+/*
+ * Returns the memory of a filter, see filter.h.
+ */
+uint_t filter_memory(filter_kind_t kind)
+{
+    switch(kind)
+    {
+    case FILTER_MEDIAN:
+        return sizeof(filter_medians);
+    case FILTER_EMA:
+        return sizeof(filter_emas);
+    case FILTER_GATE:
+        return sizeof(filter_gates);
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * filter.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the filter.c file.
+ *
+ * */
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "types.h"
+#include "fixed.h"
+#include "motor.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define FILTER_BEARINGS     (USR_MAX_POS + 1)
+                                    // Motor positions with their own state
+
+#define FILTER_STAGES_MAX   (4)     // Longest chain of filters
+
+#define FILTER_EMA_WEIGHT   Q15(0.8)
+                                    // Weight of a new distance in the average
+
+#define FILTER_GATE_US      (1200)  // Largest change of the distance at a
+                                    // bearing accepted by the gate, about
+                                    // 20 cm, in microseconds of echo
+#define FILTER_GATE_MAX     (FILTER_GATE_US / DISTANCE_PERIOD)
+#define FILTER_GATE_HOLD    (3)     // Changes rejected in a row after which
+                                    // the gate accepts them, as the object
+                                    // really moved
+
+/*
+ * Filters applied by default. Defining __FILTER_ROBUST__ removes single
+ * spurious distances before averaging.
+ */
+#if defined(__FILTER_ROBUST__)
+#define FILTER_CHAIN_DEFAULT    { FILTER_MEDIAN, FILTER_GATE, FILTER_EMA }
+#else
+#define FILTER_CHAIN_DEFAULT    { FILTER_EMA }
+#endif
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Filters that can be chained, each one keeping its own state for each
+ * bearing.
+ */
+typedef enum
+{
+    FILTER_MEDIAN,          // Median of the last 3 distances
+    FILTER_EMA,             // Exponential moving average, see
+                            // FILTER_EMA_WEIGHT
+    FILTER_GATE,            // Rejects sudden changes, see FILTER_GATE_MAX
+    FILTER_KINDS,           // Number of filters
+} filter_kind_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets all the distances seen at all the bearings and sets the default
+ * chain of filters.
+ */
+extern void filter_init();
+
+/*
+ * Sets the filters applied to each distance, in order, and forgets all the
+ * distances seen. An empty chain passes the distances unchanged. Returns
+ * false, leaving the chain unchanged, if it is longer than FILTER_STAGES_MAX
+ * or contains unknown filters.
+ */
+extern bool_t filter_set_chain(const filter_kind_t kinds[], int_t count);
+
+/*
+ * Copies the filters applied in kinds, which shall hold FILTER_STAGES_MAX of
+ * them, and returns their number.
+ */
+extern int_t filter_get_chain(filter_kind_t kinds[]);
+
+/*
+ * Passes a distance measured at the given bearing through the chain of
+ * filters, with the state of that bearing only, and returns the filtered one.
+ * Distances at bearings out of USR_MIN_POS..USR_MAX_POS are not filtered.
+ */
+extern distance_t filter_update(int_t bearing, distance_t distance);
+
+/*
+ * Returns the distance of the last filter_update as output by the stages
+ * before the moving average, i.e. with the spurious distances removed but not
+ * smoothed, or as given if there are none. Consumers that smooth by
+ * themselves, like the tracker, take this one.
+ */
+extern distance_t filter_get_robust();
+
+/*
+ * Returns the bytes of state kept by a filter for all the bearings.
+ */
+extern uint_t filter_memory(filter_kind_t kind);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * fixed.h
+ *
+ * This file contains the fixed point types and operations used instead of
+ * floating point arithmetic, which the Cortex-M4F runs in software for double
+ * values.
+ *
+ * Operations use only integer multiplications, additions and arithmetic right
+ * shifts, rounding to the nearest value, so that they give the same bits on
+ * the board and on the host. Constants are converted from their decimal value
+ * at compile time.
+ *
+ * */
+
+#ifndef FIXED_H
+#define FIXED_H
+
+#include "types.h"
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+typedef int16_t     q15_t;      // Fraction in -1..1, 15 fractional bits
+typedef int32_t     q16_t;      // Real number, 16 integer and 16 fractional
+                                // bits
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define Q15_SHIFT   (15)
+#define Q16_SHIFT   (16)
+
+#define Q15_ONE     (1L << Q15_SHIFT)   // Not a q15_t, for wider results
+#define Q16_ONE     (1L << Q16_SHIFT)
+
+// Converts a constant to fixed point, rounding to the nearest value. It shall
+// be used only on constants, so that no floating point code is generated.
+#define Q15(x)  STATIC_CAST(q15_t, (x) * Q15_ONE + ((x) < 0 ? -0.5 : 0.5))
+#define Q16(x)  STATIC_CAST(q16_t, (x) * Q16_ONE + ((x) < 0 ? -0.5 : 0.5))
+
+/* ---------------------------
+ * Operations
+ * ---------------------------
+ */
+
+// Multiplies an integer, or a Q15 value, by a Q15 fraction. The product shall
+// fit in 31 bits.
+#define Q15_MUL(a, q) \
+    STATIC_CAST(long_int_t, (STATIC_CAST(long_int_t,a) * (q) + (1L << (Q15_SHIFT - 1))) >> Q15_SHIFT)
+
+// Multiplies an integer, or a Q16 value, by a Q16 number
+#define Q16_MUL(a, q) \
+    STATIC_CAST(long_int_t, (STATIC_CAST(int64_t,a) * (q) + (1L << (Q16_SHIFT - 1))) >> Q16_SHIFT)
+
+// Moves a value towards a target by the given Q15 fraction of their
+// difference, that is q * target + (1 - q) * value with a single product
+#define Q15_BLEND(value, target, q) \
+    ((value) + Q15_MUL(STATIC_CAST(long_int_t,target) - (value), q))
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ * geometry.c
+ *
+ * This file contains the triangolation of the objects seen by the left and
+ * the right sensor, which lie at the two ends of a short baseline on the
+ * rotating head.
+ *
+ * An object at lateral distance w from the middle of the sensors (positive
+ * towards the left one) and at distance v along the beam is seen at
+ *
+ *     lx^2 = (w - b/2)^2 + v^2        rx^2 = (w + b/2)^2 + v^2
+ *
+ * where b is the separation of the sensors, so that w = (rx^2 - lx^2) / 2b
+ * and its range is r^2 = (lx^2 + rx^2) / 2 - b^2 / 4. Its offset from the beam
+ * axis is then asin(w / r). All the computations are in integer arithmetic,
+ * square roots are computed bit by bit and trigonometry uses a table.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "sensor_config.h"
+#include "geometry.h"
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+// Sine of each angle unit of the first quadrant, with GEO_SIN_SHIFT
+// fractional bits
+static const uint16_t geo_sin_table[GEO_QUARTER + 1] =
+{
+        0,   201,   402,   603,   804,  1005,  1206,  1407,
+     1608,  1809,  2009,  2210,  2411,  2611,  2811,  3012,
+     3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+     6393,  6590,  6787,  6983,  7180,  7376,  7571,  7767,
+     7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+     9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850,
+    11039, 11228, 11417, 11605, 11793, 11980, 12167, 12354,
+    12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+    15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673,
+    16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358,
+    19520, 19681, 19841, 20001, 20160, 20318, 20475, 20632,
+    20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028,
+    23170, 23312, 23453, 23593, 23732, 23870, 24008, 24144,
+    24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199,
+    26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+    27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803,
+    28899, 28993, 29086, 29178, 29269, 29359, 29448, 29535,
+    29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784,
+    30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298,
+    31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099,
+    32138, 32177, 32214, 32251, 32286, 32319, 32352, 32383,
+    32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718,
+    32729, 32738, 32746, 32753, 32758, 32762, 32766, 32767,
+    32768
+};
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Computes the integer square root one bit at a time, see geometry.h.
+ */
+uint32_t geo_isqrt(uint32_t n)
+{
+    uint32_t    root = 0;
+    uint32_t    bit = 1ul << 30;
+
+    while(bit > n)
+        bit >>= 2;
+
+    while(bit)
+    {
+        if(n >= root + bit)
+        {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+            root >>= 1;
+
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+/*
+ * Looks up the sine in the table of the first quadrant, see geometry.h.
+ */
+long_int_t geo_sin(int_t angle)
+{
+    int_t   a = angle & (GEO_TURN - 1);
+
+    if(a < GEO_QUARTER)
+        return geo_sin_table[a];
+    if(a < 2 * GEO_QUARTER)
+        return geo_sin_table[2 * GEO_QUARTER - a];
+    if(a < 3 * GEO_QUARTER)
+        return -STATIC_CAST(long_int_t, geo_sin_table[a - 2 * GEO_QUARTER]);
+
+    return -STATIC_CAST(long_int_t, geo_sin_table[GEO_TURN - a]);
+}
+
+/*
+ * Looks up the cosine as the sine of the complementary angle, see geometry.h.
+ */
+long_int_t geo_cos(int_t angle)
+{
+    return geo_sin(angle + GEO_QUARTER);
+}
+
+/*
+ * Searches the table of the first quadrant, see geometry.h.
+ */
+int_t geo_asin(long_int_t sine)
+{
+    long_int_t  value = sine < 0 ? -sine : sine;
+    int_t       low = 0;
+    int_t       high = GEO_QUARTER;
+    int_t       mid;
+
+    if(value >= GEO_ONE)
+        return sine < 0 ? -GEO_QUARTER : GEO_QUARTER;
+
+    // First angle whose sine is not lower than the value
+    while(low < high)
+    {
+        mid = (low + high) / 2;
+
+        if(geo_sin_table[mid] < value)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if(low > 0 && value - geo_sin_table[low - 1] < geo_sin_table[low] - value)
+        --low;
+
+    return sine < 0 ? -low : low;
+}
+
+/*
+ * Locates an object from the distances of the two sensors, see geometry.h.
+ */
+void geo_locate(long_int_t lx, long_int_t rx, int_t pos, geo_point_t* point)
+{
+    long_int_t  lateral;
+    long_int_t  square;
+
+    // Differences of squares are computed as products, without overflows
+    lateral = (rx - lx) * (rx + lx) / (2 * SENSORS_SEPARATION_MM);
+    square = (lx * lx + rx * rx) / 2 - SENSORS_SEPARATION_MM * SENSORS_SEPARATION_MM / 4;
+
+    point->range = square > 0 ? STATIC_CAST(long_int_t, geo_isqrt(square)) : 0;
+
+    // Distances differing more than the separation come from different
+    // objects or from noise, the object is at most at the edge of the beam
+    if(lateral > point->range)
+        lateral = point->range;
+    if(lateral < -point->range)
+        lateral = -point->range;
+
+    // Lateral is negative on the left, so it is scaled without shifting it
+    point->offset = point->range > 0 ?
+            geo_asin(lateral * (1L << GEO_SIN_SHIFT) / point->range) : 0;
+
+    if(point->offset > GEO_BEAM_HALF)
+        point->offset = GEO_BEAM_HALF;
+    if(point->offset < -GEO_BEAM_HALF)
+        point->offset = -GEO_BEAM_HALF;
+
+    point->angle = GEO_POS_TO_ANGLE(pos) + point->offset;
+
+    point->x = (point->range * geo_cos(point->angle)) >> GEO_SIN_SHIFT;
+    point->y = (point->range * geo_sin(point->angle)) >> GEO_SIN_SHIFT;
+}
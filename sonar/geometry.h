@@ -0,0 +1,88 @@
+/*
+ * geometry.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the geometry.c file.
+ *
+ * */
+
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include "types.h"
+#include "fixed.h"
+#include "motor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define GEO_TURN        (1024)  // Angle units in a full turn, about 0.35 deg
+#define GEO_QUARTER     (GEO_TURN / 4)
+
+#define GEO_SIN_SHIFT   Q15_SHIFT
+                                // Fractional bits of sines and cosines
+#define GEO_ONE         Q15_ONE
+
+#define GEO_BEAM_HALF   (43)    // Half aperture of the sensors beam, 15 deg,
+                                // the widest offset of an object
+
+// Angle of the beam at a user position, from GEO_TURN / 2 at USR_MIN_POS to 0
+// at USR_MAX_POS. A position is GEO_TURN / 2 / USR_RANGE units, 8 with the
+// default motor step.
+#define GEO_POS_TO_ANGLE(pos) \
+    STATIC_CAST(int_t, STATIC_CAST(long_int_t, USR_MAX_POS - (pos)) * (GEO_TURN / 2) / USR_RANGE)
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Contains the position of an object located by two sensors. The origin is
+ * the middle of the sensors, the x axis points to angle 0 and the y axis to
+ * angle GEO_QUARTER, as drawn on the screen.
+ */
+typedef struct GEO_POINT_STRUCT
+{
+    long_int_t  x;          // Coordinates in mm
+    long_int_t  y;
+    long_int_t  range;      // Distance in mm
+    int_t       angle;      // Angle of the object in angle units
+    int_t       offset;     // Angle of the object from the beam axis, positive
+                            // towards the left sensor
+} geo_point_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Returns the largest integer whose square is not greater than n.
+ */
+extern uint32_t geo_isqrt(uint32_t n);
+
+/*
+ * Returns the sine and the cosine of an angle in angle units, with
+ * GEO_SIN_SHIFT fractional bits.
+ */
+extern long_int_t geo_sin(int_t angle);
+extern long_int_t geo_cos(int_t angle);
+
+/*
+ * Returns the angle in -GEO_QUARTER..GEO_QUARTER whose sine, with
+ * GEO_SIN_SHIFT fractional bits, is the nearest to the given one.
+ */
+extern int_t geo_asin(long_int_t sine);
+
+/*
+ * Locates an object seen at the given distances in mm by the left and the
+ * right sensor, with the beam at the given user position. The difference of
+ * the distances over the sensors separation gives the offset of the object
+ * within the beam.
+ */
+extern void geo_locate(long_int_t lx, long_int_t rx, int_t pos, geo_point_t* point);
+
+#endif
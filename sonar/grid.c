@@ -0,0 +1,194 @@
+/*
+ * grid.c
+ *
+ * This file contains the occupancy grid of the area swept by the sonar. Each
+ * distance measured at a motor position frees the cells of the beam axis
+ * before it and marks as occupied the ones at the distance across the beam,
+ * accumulating the log-odds of each cell over the sweeps.
+ *
+ * The cells crossed by the axis at each position are computed once by
+ * grid_init, the nearest one for each cell of distance: these stencils give
+ * both the cells before a distance and the one at it without any
+ * trigonometry, and the ones across the beam at the same distance are taken
+ * from the stencils of the positions next to it. A distance writes then at
+ * most GRID_WRITES_MAX cells.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "grid.h"
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static grid_cell_t  grid_cells[GRID_CELLS];
+static uint16_t     grid_stencils[GRID_BEARINGS][GRID_RANGE];
+                            // Cell crossed by the beam axis at each bearing,
+                            // for each distance in cells
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Adds to the log-odds of a cell, within -GRID_LIMIT..GRID_LIMIT.
+ */
+void grid_add(uint16_t cell, int_t log_odds)
+{
+    log_odds += grid_cells[cell];
+
+    if(log_odds > GRID_LIMIT)
+        log_odds = GRID_LIMIT;
+    else if(log_odds < -GRID_LIMIT)
+        log_odds = -GRID_LIMIT;
+
+    grid_cells[cell] = STATIC_CAST(grid_cell_t, log_odds);
+}
+
+/*
+ * Computes the cells crossed by the beam axis at a bearing, the nearest one
+ * for each cell of distance.
+ */
+void grid_stencil(int_t bearing)
+{
+    const int_t         angle = GEO_POS_TO_ANGLE(bearing + USR_MIN_POS);
+    const long_int_t    cosine = geo_cos(angle);
+    const long_int_t    sine = geo_sin(angle);
+    long_int_t          col;
+    long_int_t          row;
+    int_t               k;
+
+    for(k = 0; k < GRID_RANGE; ++k)
+    {
+        col = GRID_ORIGIN + ((k * cosine + GEO_ONE / 2) >> GEO_SIN_SHIFT);
+        row = (k * sine + GEO_ONE / 2) >> GEO_SIN_SHIFT;
+
+        grid_stencils[bearing][k] = STATIC_CAST(uint16_t, row * GRID_WIDTH + col);
+    }
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Computes the stencils, see grid.h.
+ */
+void grid_init()
+{
+    int_t i;
+
+    for(i = 0; i < GRID_BEARINGS; ++i)
+        grid_stencil(i);
+
+    grid_clear();
+}
+
+/*
+ * Sets all the cells to unknown.
+ */
+void grid_clear()
+{
+    uint_t i;
+
+    for(i = 0; i < GRID_CELLS; ++i)
+        grid_cells[i] = 0;
+}
+
+/*
+ * Adds a distance measured at a motor position, see grid.h.
+ */
+uint_t grid_update(int_t pos, distance_t distance)
+{
+    const uint16_t* axis;
+    uint16_t        hit;
+    uint16_t        last;
+    long_int_t      mm;
+    int_t           range = GRID_RANGE;
+    int_t           side;
+    int_t           k;
+    uint_t          writes = 0;
+
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return 0;
+
+    pos -= USR_MIN_POS;
+    axis = grid_stencils[pos];
+
+    if(distance < SENSOR_DIST_MAX)
+    {
+        mm = DISTANCE_TO_MM(distance);
+
+        mm = (mm + GRID_CELL_MM / 2) / GRID_CELL_MM;
+
+        if(mm < GRID_RANGE)
+            range = STATIC_CAST(int_t, mm);
+    }
+
+    hit = range < GRID_RANGE ? axis[range] : GRID_CELLS;
+
+    // Nearby cells of distance may fall in the same cell, written only once
+    for(k = 0; k < range && axis[k] != hit; ++k)
+    {
+        if(k > 0 && axis[k] == axis[k - 1])
+            continue;
+
+        grid_add(axis[k], GRID_MISS);
+        ++writes;
+    }
+
+    if(range == GRID_RANGE)
+        return writes;
+
+    grid_add(hit, GRID_HIT);
+    ++writes;
+
+    // The object can be anywhere across the beam, on both sides
+    for(side = -1; side <= 1; side += 2)
+    {
+        last = hit;
+
+        for(k = 1; k <= GRID_BEAM_SIDE; ++k)
+        {
+            if(pos + side * k < 0 || pos + side * k >= GRID_BEARINGS)
+                break;
+
+            if(grid_stencils[pos + side * k][range] == last)
+                continue;
+
+            last = grid_stencils[pos + side * k][range];
+
+            grid_add(last, GRID_HIT_SIDE);
+            ++writes;
+        }
+    }
+
+    return writes;
+}
+
+/*
+ * Returns the log-odds of a cell, see grid.h.
+ */
+grid_cell_t grid_get(int_t col, int_t row)
+{
+    if(col < 0 || col >= GRID_WIDTH || row < 0 || row >= GRID_HEIGHT)
+        return 0;
+
+    return grid_cells[row * GRID_WIDTH + col];
+}
+
+/*
+ * Returns the memory of the grid, see grid.h.
+ */
+uint_t grid_memory()
+{
+    return sizeof(grid_cells) + sizeof(grid_stencils);
+}
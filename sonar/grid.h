@@ -0,0 +1,98 @@
+/*
+ * grid.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the grid.c file.
+ *
+ * */
+
+#ifndef GRID_H
+#define GRID_H
+
+#include "types.h"
+#include "motor.h"
+#include "sensor.h"
+#include "geometry.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define GRID_CELL_MM    (64)    // Side of a cell
+#define GRID_RANGE      (64)    // Cells from the sonar to the farthest row,
+                                // about 4 m
+#define GRID_WIDTH      (2 * GRID_RANGE - 1)
+#define GRID_HEIGHT     (GRID_RANGE)
+#define GRID_CELLS      (GRID_WIDTH * GRID_HEIGHT)
+#define GRID_ORIGIN     (GRID_RANGE - 1)
+                                // Column of the sonar, which is at the middle
+                                // of the first row looking towards the last
+
+#define GRID_BEARINGS   (USR_MAX_POS + 1)
+                                // Motor positions with their own stencil
+
+#define GRID_BEAM_SIDE  (GEO_BEAM_HALF * USR_RANGE / (GEO_TURN / 2))
+                                // Bearings on each side of the beam axis
+                                // whose cells at the range are hit too
+
+/*
+ * Each cell holds the log-odds of being occupied, 16 for each nat: 0 is
+ * unknown, positive values occupied and negative ones free. They are kept in
+ * -GRID_LIMIT..GRID_LIMIT so that a cell can change its state within a few
+ * sweeps.
+ */
+#define GRID_UNIT       (16)
+#define GRID_HIT        (12)    // Added to the cells at the range on the axis
+#define GRID_HIT_SIDE   (6)     // Added to the cells at the range on the sides
+#define GRID_MISS       (-4)    // Added to the cells before the range
+#define GRID_LIMIT      (96)
+
+#define GRID_WRITES_MAX (GRID_RANGE + 2 * GRID_BEAM_SIDE + 1)
+                                // Most cells written by a single distance
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+typedef int8_t      grid_cell_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Computes the cells crossed by the beam at each bearing and clears the grid.
+ */
+extern void grid_init();
+
+/*
+ * Sets all the cells to unknown.
+ */
+extern void grid_clear();
+
+/*
+ * Adds a distance measured at the given motor position: the cells of the axis
+ * before it are free, the ones at the distance across the beam occupied.
+ * SENSOR_DIST_MAX, or any distance beyond the grid, frees the whole axis.
+ * Returns the number of cells written, at most GRID_WRITES_MAX, 0 for
+ * positions out of USR_MIN_POS..USR_MAX_POS.
+ */
+extern uint_t grid_update(int_t pos, distance_t distance);
+
+/*
+ * Returns the log-odds of the cell at the given column and row. The sonar is
+ * in the middle of the cell at column GRID_ORIGIN of row 0, columns grow along
+ * the x axis and rows along the y axis of geo_point_t (see geometry.h). Cells
+ * out of the grid are unknown.
+ */
+extern grid_cell_t grid_get(int_t col, int_t row);
+
+/*
+ * Returns the bytes of the cells and of the stencils.
+ */
+extern uint_t grid_memory();
+
+#endif
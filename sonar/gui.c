@@ -139,16 +139,37 @@ void gui_change_zoom_level()
 }
 
 /*
- * Sets the current position of the motor and the distance that has been
- * measured for that distance.
+ * Returns the maximum distance displayed at the current zoom level, in cm.
  */
-void gui_set_position(int_t pos, int_t distance)
+int_t gui_get_max_distance()
+{
+    return ZOOM_LEVEL_MAX_DISTANCE(gui_state.zoom_level);
+}
+
+/*
+ * Sets the current position of the motor.
+ */
+void gui_set_position(int_t pos)
 {
     gui_state.motor_pos = pos;
+}
 
+/*
+ * Sets the distance, in mm, of the obstacle displayed at the given position.
+ */
+void gui_set_obstacle(int_t pos, int_t distance)
+{
     widget_sonar_set_obstacle(&widgets[WID_SONAR], pos, distance);
 }
 
+/*
+ * Sets the distances of the further echoes seen at the given position.
+ */
+void gui_set_returns(int_t pos, const int_t distances[], int_t count)
+{
+    widget_sonar_set_returns(&widgets[WID_SONAR], pos, distances, count);
+}
+
 /*
  * Shows on the screen the calibration message.
  */
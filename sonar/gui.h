@@ -19,10 +19,26 @@ extern void gui_init();
 extern void gui_change_zoom_level();
 
 /*
- * Sets the current position of the motor and the distance that has been
- * measured for that distance.
+ * Returns the maximum distance displayed at the current zoom level, in cm.
  */
-extern void gui_set_position(int_t pos, int_t distance);
+extern int_t gui_get_max_distance();
+
+/*
+ * Sets the current position of the motor.
+ */
+extern void gui_set_position(int_t pos);
+
+/*
+ * Sets the distance, in mm, of the obstacle displayed at the given position,
+ * such as the one predicted there since it was measured.
+ */
+extern void gui_set_obstacle(int_t pos, int_t distance);
+
+/*
+ * Sets the distances, in mm, of the further echoes seen at the given position,
+ * behind the obstacle set by gui_set_obstacle.
+ */
+extern void gui_set_returns(int_t pos, const int_t distances[], int_t count);
 
 /*
  * Shows on the screen the calibration message.
@@ -0,0 +1,24 @@
+/*
+ * hal.h
+ *
+ * This file selects the hardware libraries used by the platform independent
+ * modules. On the board these are the STM32F4 libraries, while on the host
+ * (SONAR_HOST defined) a stub provided by the test-suite is used instead.
+ *
+ * */
+
+#ifndef HAL_H
+#define HAL_H
+
+#ifdef SONAR_HOST
+#include "hal_stub.h"
+#else
+#include "ee.h"
+#include "lib/tm_stm32f4_gpio.h"
+
+// Critical section of a task against all the interrupt handlers
+#define HAL_SUSPEND()   SuspendAllInterrupts()
+#define HAL_RESUME()    ResumeAllInterrupts()
+#endif
+
+#endif
@@ -10,13 +10,13 @@
  * ---------------------------
  */
 
-#include <math.h>
-
 #include "stm32f4_discovery_lcd.h"
 
 #include "widget.h"
 #include "widget_config.h"
 #include "../sensor.h"
+#include "../geometry.h"
+#include "../fixed.h"
 
 
 /* ---------------------------
@@ -208,11 +208,12 @@ void set_num_text(widget_t* wid, int_t num)
 // ------------------ Functions used for the sonar ------------------
 
 
+// Angles are in the units of geometry.h, see GEO_POS_TO_ANGLE
 #define COORDINATE_X(wid, angle, dist) \
-    STATIC_CAST(int_t, cos(angle) * dist + wid->pivot_x)
+    STATIC_CAST(int_t, wid->pivot_x + Q15_MUL(dist, geo_cos(angle)))
 
 #define COORDINATE_Y(wid, angle, dist) \
-    STATIC_CAST(int_t, wid->pivot_y - sin(angle) * dist)
+    STATIC_CAST(int_t, wid->pivot_y - Q15_MUL(dist, geo_sin(angle)))
 
 /*
  * Draws a line at the given angle.
@@ -221,7 +222,7 @@ void draw_line(widget_sonar_t* wid)
 {
     int_t x;
     int_t y;
-    double angle = motor_pos_to_angle(wid->pos);
+    int_t angle = GEO_POS_TO_ANGLE(wid->pos);
 
     x = COORDINATE_X(wid, angle, wid->line_length);
     y = COORDINATE_Y(wid, angle, wid->line_length);
@@ -232,35 +233,45 @@ void draw_line(widget_sonar_t* wid)
 }
 
 /*
- * Draws a line at the given angle.
+ * Draws a point at the given angle and distance, if it is in sight.
  */
-void draw_points(widget_sonar_t* wid)
+void draw_point(widget_sonar_t* wid, int_t angle, int_t dist, color_t color)
 {
     int_t x;
     int_t y;
-    int_t dist;
-    double angle;
-    int_t i;
 
     const int_t max_distance = wid->max_distance;
 
-    //LCD_SetTextColor(WID_COLOR_POINT);
+    if(dist > max_distance)
+         return;
 
-    for(i = USR_MIN_POS; i <= USR_MAX_POS; ++i)
-    {
-        angle = motor_pos_to_angle(i);
+    dist = STATIC_CAST(long_int_t, dist) * wid->line_length / max_distance;
+
+    x = COORDINATE_X(wid, angle, dist);
+    y = COORDINATE_Y(wid, angle, dist);
 
-        dist = wid->obstacles[i];
+    LCD_DrawFilledRect(x-1, y-1, x+1, y+1, color, color);
+}
+
+/*
+ * Draws the obstacles and the further echoes at all the angles.
+ */
+void draw_points(widget_sonar_t* wid)
+{
+    int_t angle;
+    int_t i;
+    int_t j;
 
-        if(dist > max_distance)
-             continue;
+    //LCD_SetTextColor(WID_COLOR_POINT);
 
-        dist = dist * wid->line_length / max_distance;
+    for(i = USR_MIN_POS; i <= USR_MAX_POS; ++i)
+    {
+        angle = GEO_POS_TO_ANGLE(i);
 
-        x = COORDINATE_X(wid, angle, dist);
-        y = COORDINATE_Y(wid, angle, dist);
+        for(j = 0; j < wid->returns_num[i]; ++j)
+            draw_point(wid, angle, wid->returns[i][j], WID_COLOR_RETURN);
 
-        LCD_DrawFilledRect(x-1, y-1, x+1, y+1, WID_COLOR_POINT, WID_COLOR_POINT);
+        draw_point(wid, angle, wid->obstacles[i], WID_COLOR_POINT);
     }
 }
 
@@ -329,7 +340,7 @@ void widget_sonar_refresh(widget_t* wid, int_t pos)
 }
 
 /*
- * Sets the measured distance at the given user position.
+ * Sets the measured distance, in mm, at the given user position.
  */
 void widget_sonar_set_obstacle(widget_t* wid, int_t pos, int_t distance)
 {
@@ -342,6 +353,28 @@ void widget_sonar_set_obstacle(widget_t* wid, int_t pos, int_t distance)
     ptr->obstacles[pos] = distance;
 }
 
+/*
+ * Sets the distances of the further echoes seen at the given user position.
+ */
+void widget_sonar_set_returns(widget_t* wid, int_t pos, const int_t distances[], int_t count)
+{
+    widget_sonar_t* ptr;
+    int_t           i;
+
+    if(wid->type != WIDGET_SONAR)
+        return;
+
+    ptr = STATIC_CAST(widget_sonar_t*, wid->data);
+
+    if(count > WID_SONAR_RETURNS)
+        count = WID_SONAR_RETURNS;
+
+    for(i = 0; i < count; ++i)
+        ptr->returns[pos][i] = distances[i];
+
+    ptr->returns_num[pos] = count;
+}
+
 /*
  * Sets the maximum distance (in centimeters) that can be displayed. Used mainly
  * to change zoom level.
@@ -354,5 +387,5 @@ void widget_sonar_set_max_dist(widget_t* wid, int_t max_distance)
         return;
 
     ptr = STATIC_CAST(widget_sonar_t*, wid->data);
-    ptr->max_distance = max_distance;
+    ptr->max_distance = max_distance * 10;
 }
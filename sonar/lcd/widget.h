@@ -13,6 +13,8 @@
 #include "../types.h"
 #include "../motor.h"
 
+#define WID_SONAR_RETURNS   (6)     // Further echoes displayed at each position
+
 /* ---------------------------
  * Data types
  * ---------------------------
@@ -81,8 +83,12 @@ typedef struct WID_SONAR_STRUCT
     const int_t pivot_x;
     const int_t pivot_y;
     int_t       pos;
-    int_t       max_distance;
+    int_t       max_distance;   // Maximum distance displayed, in mm
     int_t       obstacles[USR_MAX_POS+1];
+                                // Distance measured at each position, in mm
+    int_t       returns[USR_MAX_POS+1][WID_SONAR_RETURNS];
+                                // Further echoes seen at each position
+    int_t       returns_num[USR_MAX_POS+1];
 } widget_sonar_t;
 
 
@@ -121,10 +127,16 @@ extern void widget_print_num(widget_t* wid, int_t num);
 extern void widget_sonar_refresh(widget_t* wid, int_t pos);
 
 /*
- * Sets the measured distance at the given user position.
+ * Sets the measured distance, in mm, at the given user position.
  */
 extern void widget_sonar_set_obstacle(widget_t* wid, int_t pos, int_t distance);
 
+/*
+ * Sets the distances of the further echoes seen at the given user position,
+ * displayed behind the obstacle. Only the first WID_SONAR_RETURNS are kept.
+ */
+extern void widget_sonar_set_returns(widget_t* wid, int_t pos, const int_t distances[], int_t count);
+
 /*
  * Sets the maximum distance (in centimeters) that can be displayed. Used mainly
  * to change zoom level.
@@ -313,7 +313,7 @@ static widget_sonar_t sonar =
     .pivot_x = WID_SONAR_PIVOT_X,
     .pivot_y = WID_SONAR_PIVOT_Y,
     .pos = 0,
-    .obstacles = { [0 ... USR_MAX_POS] = DISTANCE_TO_CM(SENSOR_DIST_MAX) },
+    .obstacles = { [0 ... USR_MAX_POS] = SENSOR_DIST_MAX_MM },
 };
 
 
@@ -60,6 +60,7 @@ extern widget_t widgets[WID_NUM];
 
 #define WID_COLOR_TEXT  (0x6d66u)       // Light green
 #define WID_COLOR_POINT (0xb9a8u)       // Reddish purple
+#define WID_COLOR_RETURN (0x5d1cu)      // Light blue
 
 
 #endif
@@ -9,8 +9,6 @@
 // ---------------------------
 // Includes
 // ---------------------------
-#include <math.h>
-
 #include "ee.h"
 
 #include "lib/tm_stm32f4_pwm.h"
@@ -49,14 +47,12 @@ motor_t motor_state;      // Motor instance
  * ret: motor position in user range domain
  */
 int_t motor_get_motor_pos(int_t user_pos) {
-    double motor_pos;
-
     if (user_pos < USR_MIN_POS)
         return MOTOR_MIN;
     else if (user_pos > USR_MAX_POS)
         return MOTOR_MAX;
 
-    return MOTOR_MIN + 1.0 / USR_RANGE_SLOPE * (user_pos - USR_MIN_POS);
+    return USR_TO_MOTOR_POS(user_pos);
 }
 
 /*
@@ -143,12 +139,5 @@ void motor_step() {
 
 int_t motor_get_pos()
 {
-    return (USR_MIN_POS + USR_RANGE_SLOPE * (motor_state.curr_pos - MOTOR_MIN));
-}
-
-/*
- * Converts a user position to the corresponding angle in radians.
- */
-double motor_pos_to_angle(int_t usr_pos) {
-    return STATIC_CAST(double, USR_MAX_POS - usr_pos /*+ USR_MIN_POS*/) * M_PI / USR_RANGE;
+    return MOTOR_TO_USR_POS(motor_state.curr_pos);
 }
@@ -10,6 +10,7 @@
 #define MOTOR_H
 
 #include "types.h"
+#include "fixed.h"
 
 // ---------------------------
 // PWM motor constant
@@ -25,6 +26,17 @@
 #define MOTOR_RANGE (MOTOR_MAX-MOTOR_MIN)
                             // The range of the positions of the motor
 
+#define MOTOR_FRAME_US  (1000000 / MOTOR_FRQ)
+                            // Defines the PWM period in microseconds, the
+                            // servo reads a new position once per frame
+#define MOTOR_SLEW_US   (5000)
+                            // Defines the time in microseconds the servo takes
+                            // to move by MOTOR_STP, about 3 degrees at
+                            // 0.1 s / 60 degrees
+#define MOTOR_SETTLE_US (MOTOR_FRAME_US + MOTOR_SLEW_US)
+                            // Defines the time in microseconds from a new
+                            // position to the servo being there
+
 // --------------------------
 // User domain position range
 // --------------------------
@@ -37,9 +49,16 @@
 
 #define USR_RANGE       (USR_MAX_POS - USR_MIN_POS)
 
-#define USR_RANGE_SLOPE (((double)USR_MAX_POS-(double)USR_MIN_POS) \
-        / (double)MOTOR_RANGE)
-                            // Defines the slope of user range map
+#define USR_RANGE_SLOPE Q16(STATIC_CAST(double, USR_RANGE) / MOTOR_RANGE)
+                            // Defines the slope of user range map, in Q16
+#define MOTOR_RANGE_SLOPE Q16(STATIC_CAST(double, MOTOR_RANGE) / USR_RANGE)
+                            // Defines the slope of its inverse, in Q16
+
+// Converts between motor and user positions, see fixed.h
+#define MOTOR_TO_USR_POS(pos) \
+    STATIC_CAST(int_t, USR_MIN_POS + Q16_MUL((pos) - MOTOR_MIN, USR_RANGE_SLOPE))
+#define USR_TO_MOTOR_POS(pos) \
+    STATIC_CAST(int_t, MOTOR_MIN + Q16_MUL((pos) - USR_MIN_POS, MOTOR_RANGE_SLOPE))
 
 // ------------------------
 // STM32F4 timer/pwm pinout
@@ -106,9 +125,4 @@ extern void motor_set_dir(direction_t direction);
  */
 extern void motor_step();
 
-/*
- * Converts a user position to the corresponding angle in radians.
- */
-extern double motor_pos_to_angle(int_t usr_pos);
-
 #endif
@@ -0,0 +1,157 @@
+/*
+ * nearest.c
+ *
+ * This file contains the search of the nearest object among the distances
+ * measured at all the bearings, or at the bearings of a sector.
+ *
+ * Distances are the leaves of a binary tree of minimums, stored in an array
+ * as a heap: node i has children 2i and 2i + 1, the leaves being from
+ * NEAREST_BEARINGS. Each node holds the bearing of the least distance below
+ * it, so that setting a distance updates only its ancestors and a sector is
+ * covered by at most two nodes for each level.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "nearest.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define NEAREST_NONE    (-1)    // No bearing, farther than all of them
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static distance_t   nearest_distances[NEAREST_BEARINGS];
+static uint8_t      nearest_tree[2 * NEAREST_BEARINGS];
+                                // Bearing of the least distance below each
+                                // node, from 1, the root
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Returns the bearing of the nearest distance between two, the lowest one if
+ * they are equal.
+ */
+int_t nearest_min(int_t a, int_t b)
+{
+    if(a == NEAREST_NONE)
+        return b;
+
+    if(b == NEAREST_NONE)
+        return a;
+
+    if(nearest_distances[a] != nearest_distances[b])
+        return nearest_distances[a] < nearest_distances[b] ? a : b;
+
+    return a < b ? a : b;
+}
+
+/*
+ * Copies a bearing and its distance, returning whether something is in sight
+ * there.
+ */
+bool_t nearest_copy(int_t id, int_t* pos, distance_t* distance)
+{
+    if(id == NEAREST_NONE || nearest_distances[id] >= SENSOR_DIST_MAX)
+        return false;
+
+    *pos = id + USR_MIN_POS;
+    *distance = nearest_distances[id];
+
+    return true;
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets all the distances, see nearest.h.
+ */
+void nearest_init()
+{
+    int_t i;
+
+    for(i = 0; i < NEAREST_BEARINGS; ++i)
+    {
+        nearest_distances[i] = SENSOR_DIST_MAX;
+        nearest_tree[NEAREST_BEARINGS + i] = i;
+    }
+
+    for(i = NEAREST_BEARINGS - 1; i > 0; --i)
+        nearest_tree[i] = nearest_min(nearest_tree[2 * i], nearest_tree[2 * i + 1]);
+}
+
+/*
+ * Sets the distance at a position, see nearest.h.
+ */
+void nearest_update(int_t pos, distance_t distance)
+{
+    int_t i;
+
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return;
+
+    pos -= USR_MIN_POS;
+    nearest_distances[pos] = distance;
+
+    for(i = (NEAREST_BEARINGS + pos) / 2; i > 0; i /= 2)
+        nearest_tree[i] = nearest_min(nearest_tree[2 * i], nearest_tree[2 * i + 1]);
+}
+
+/*
+ * Copies the nearest object of the sweep, see nearest.h.
+ */
+bool_t nearest_get(int_t* pos, distance_t* distance)
+{
+    return nearest_copy(nearest_tree[1], pos, distance);
+}
+
+/*
+ * Copies the nearest object of a sector, see nearest.h.
+ */
+bool_t nearest_get_sector(int_t first, int_t last, int_t* pos, distance_t* distance)
+{
+    int_t best = NEAREST_NONE;
+    int_t lo;
+    int_t hi;
+
+    if(first < USR_MIN_POS)
+        first = USR_MIN_POS;
+
+    if(last > USR_MAX_POS)
+        last = USR_MAX_POS;
+
+    // From the leaves of the sector, lo included and hi excluded, the nodes
+    // out of the sector at each level are left to their parents
+    lo = NEAREST_BEARINGS + first - USR_MIN_POS;
+    hi = NEAREST_BEARINGS + last - USR_MIN_POS + 1;
+
+    while(lo < hi)
+    {
+        if(lo & 1)
+            best = nearest_min(best, nearest_tree[lo++]);
+
+        if(hi & 1)
+            best = nearest_min(best, nearest_tree[--hi]);
+
+        lo /= 2;
+        hi /= 2;
+    }
+
+    return nearest_copy(best, pos, distance);
+}
@@ -0,0 +1,56 @@
+/*
+ * nearest.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the nearest.c file.
+ *
+ * */
+
+#ifndef NEAREST_H
+#define NEAREST_H
+
+#include "types.h"
+#include "motor.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define NEAREST_BEARINGS    (USR_MAX_POS + 1)
+                                    // Motor positions searched, at most 255
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets the distances at all the bearings, so that nothing is in sight.
+ */
+extern void nearest_init();
+
+/*
+ * Sets the distance measured at the given motor position, SENSOR_DIST_MAX
+ * meaning that nothing is in sight there, in O(log NEAREST_BEARINGS).
+ * Positions out of USR_MIN_POS..USR_MAX_POS are ignored.
+ */
+extern void nearest_update(int_t pos, distance_t distance);
+
+/*
+ * Copies the position of the nearest object of the sweep and its distance,
+ * the lowest position among equal distances, in constant time. Returns false
+ * if nothing is in sight.
+ */
+extern bool_t nearest_get(int_t* pos, distance_t* distance);
+
+/*
+ * Copies the position of the nearest object between the motor positions
+ * first and last, both included, and its distance, in O(log NEAREST_BEARINGS).
+ * The sector is clipped to the sweep. Returns false if nothing is in sight
+ * there or if it is empty.
+ */
+extern bool_t nearest_get_sector(int_t first, int_t last, int_t* pos, distance_t* distance);
+
+#endif
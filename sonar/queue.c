@@ -0,0 +1,78 @@
+/*
+ * queue.c
+ *
+ * This file contains the lock free queue used to pass the measures from the
+ * interrupt handlers, where echoes are measured, to the tasks.
+ *
+ * Indexes are accessed with the atomic builtins of GCC: on the Cortex-M4 the
+ * acquire and release orderings become memory barriers around plain 32 bit
+ * loads and stores, on the host they are the usual C11 atomics, so the same
+ * code is tested with real threads.
+ *
+ * */
+
+#include "queue.h"
+
+/* ---------------------------
+ * Private macros
+ * ---------------------------
+ */
+
+// Index written by this side of the queue, no ordering needed
+#define QUEUE_LOAD_OWN(index)       __atomic_load_n(&(index), __ATOMIC_RELAXED)
+
+// Index written by the other side, records it published are visible after it
+#define QUEUE_LOAD(index)           __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+
+// Publishes the records accessed before moving the index
+#define QUEUE_STORE(index, value)   __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+#define QUEUE_WRAP(index)           ((index) & (QUEUE_SIZE - 1))
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+void queue_init(queue_t* queue)
+{
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+bool_t queue_push(queue_t* queue, const measure_t* measure)
+{
+    uint32_t head = QUEUE_LOAD_OWN(queue->head);
+
+    if(head - QUEUE_LOAD(queue->tail) >= QUEUE_SIZE)
+    {
+        ++queue->dropped;
+        return false;
+    }
+
+    queue->records[QUEUE_WRAP(head)] = *measure;
+
+    QUEUE_STORE(queue->head, head + 1);
+
+    return true;
+}
+
+bool_t queue_pop(queue_t* queue, measure_t* measure)
+{
+    uint32_t tail = QUEUE_LOAD_OWN(queue->tail);
+
+    if(tail == QUEUE_LOAD(queue->head))
+        return false;
+
+    *measure = queue->records[QUEUE_WRAP(tail)];
+
+    QUEUE_STORE(queue->tail, tail + 1);
+
+    return true;
+}
+
+uint32_t queue_count(queue_t* queue)
+{
+    return QUEUE_LOAD(queue->head) - QUEUE_LOAD(queue->tail);
+}
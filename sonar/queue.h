@@ -0,0 +1,69 @@
+/*
+ * queue.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the queue.c file.
+ *
+ * */
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define QUEUE_SIZE  (64)    // Number of records in a queue, must be a power
+                            // of 2
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Single producer single consumer ring of measures. The producer only writes
+ * head, the consumer only writes tail, so that neither needs to disable the
+ * interrupts. Both indexes run freely and are wrapped only when accessing the
+ * records.
+ */
+typedef struct QUEUE_STRUCT
+{
+    uint32_t    head;           // Next record to be written
+    uint32_t    tail;           // Next record to be read
+    uint32_t    dropped;        // Records not pushed because the queue was full
+    measure_t   records[QUEUE_SIZE];
+} queue_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Empties the queue, must not be called while it is used.
+ */
+extern void queue_init(queue_t* queue);
+
+/*
+ * Appends a copy of the measure to the queue. Returns false if the queue is
+ * full, in which case the measure is dropped. Only the producer can call it.
+ */
+extern bool_t queue_push(queue_t* queue, const measure_t* measure);
+
+/*
+ * Removes the oldest measure from the queue, copying it in measure. Returns
+ * false if the queue is empty. Only the consumer can call it.
+ */
+extern bool_t queue_pop(queue_t* queue, measure_t* measure);
+
+/*
+ * Returns the number of measures in the queue.
+ */
+extern uint32_t queue_count(queue_t* queue);
+
+#endif
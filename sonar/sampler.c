@@ -0,0 +1,275 @@
+/*
+ * sampler.c
+ *
+ * This file contains the DMA backend used to measure the echo signals. A timer
+ * requests a DMA transfer each SAMPLER_PERIOD microseconds, copying the input
+ * register of each echo port into a circular buffer, without any interrupt.
+ * The buffers are then scanned in blocks by a task (see edges.c) and the edges
+ * found are forwarded to the sensor module.
+ *
+ * Only DMA2 can read from the AHB1 GPIO ports, so TIM8 is used: each echo port
+ * of the sensor table is copied by one of its DMA requests on channel 7, see
+ * sampler_requests. The first port is copied on the update event, the others
+ * on compare events spread over the period.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "lib/tm_stm32f4_gpio.h"
+#include "lib/tm_stm32f4_timer_properties.h"
+
+#include "stm32f4xx_dma.h"
+
+#include "sensor.h"
+#include "sensor_config.h"
+#include "edges.h"
+#include "sampler.h"
+
+/* ---------------------------
+ * Private constants
+ * ---------------------------
+ */
+
+#define SAMPLER_TIMER       (TIM8)
+#define SAMPLER_DMA_CHANNEL (DMA_Channel_7)
+
+#define SAMPLER_PORTS_MAX   (4)         // Echo ports that can be sampled
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * DMA request of the sampler timer that can copy a port.
+ */
+typedef struct SAMPLER_REQUEST_STRUCT
+{
+    DMA_Stream_TypeDef* stream;     // DMA stream serving the request
+    uint16_t            dma_event;  // Timer event requesting the copy
+    uint16_t            channel;    // Compare channel of the event, unused
+                                    // for the update event
+} sampler_request_t;
+
+/*
+ * Contains the state of the sampling of a port.
+ */
+typedef struct SAMPLER_PORT_STRUCT
+{
+    GPIO_TypeDef*       port;       // Sampled port
+    DMA_Stream_TypeDef* stream;     // DMA stream copying the port
+    uint16_t            dma_event;  // Timer event requesting the copy
+
+    uint16_t            pins[SENSORS_NUM];
+                                    // Echo pin of each sensor on this port,
+                                    // zero if not on this port, filled from
+                                    // sensor_pins at initialization
+
+    uint_t              read;       // Next sample to be scanned
+    edges_t             edges;      // Edge detection state
+    uint16_t            buffer[SAMPLER_SIZE];
+} sampler_port_t;
+
+/* ---------------------------
+ * Global variables
+ * ---------------------------
+ */
+
+// Requests of TIM8 on DMA2 channel 7, in the order they are given to the ports
+static const sampler_request_t sampler_requests[SAMPLER_PORTS_MAX] =
+{
+    { DMA2_Stream1, TIM_DMA_Update, 0 },
+    { DMA2_Stream2, TIM_DMA_CC1,    TIM_Channel_1 },
+    { DMA2_Stream3, TIM_DMA_CC2,    TIM_Channel_2 },
+    { DMA2_Stream4, TIM_DMA_CC3,    TIM_Channel_3 },
+};
+
+static sampler_port_t sampler_ports[SAMPLER_PORTS_MAX];
+static int_t          sampler_ports_num = 0;
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Forwards an edge found on a port to the sensor whose echo is on that line.
+ */
+void sampler_edge(void* data, uint16_t pin, bool_t level, uint32_t index)
+{
+    sampler_port_t* sampler = STATIC_CAST(sampler_port_t*, data);
+    int_t           i;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+        if(sampler->pins[i] == pin)
+            sensors_echo_edge(i, level, index * SAMPLER_PERIOD);
+}
+
+/*
+ * Gives a DMA request to each echo port of the sensor table, in the order of
+ * the sensors. Sensors on further ports than SAMPLER_PORTS_MAX are never
+ * sampled, so they are soon reported as failing, see sensors_get_health.
+ */
+void sampler_ports_init()
+{
+    int_t i;
+    int_t j;
+
+    sampler_ports_num = 0;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        for(j = 0; j < sampler_ports_num; ++j)
+        {
+            if(sampler_ports[j].port == sensor_pins[i].echo_port)
+                break;
+        }
+
+        if(j < sampler_ports_num || sampler_ports_num == SAMPLER_PORTS_MAX)
+            continue;
+
+        sampler_ports[j].port = sensor_pins[i].echo_port;
+        sampler_ports[j].stream = sampler_requests[j].stream;
+        sampler_ports[j].dma_event = sampler_requests[j].dma_event;
+        ++sampler_ports_num;
+    }
+}
+
+/*
+ * Configures the DMA stream that copies a port into its buffer.
+ */
+void sampler_stream_init(sampler_port_t* sampler)
+{
+    DMA_InitTypeDef dma_struct;
+    uint16_t        mask = 0;
+    int_t           i;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        sampler->pins[i] = sensor_pins[i].echo_port == sampler->port ?
+                sensor_pins[i].echo_pin : 0;
+        mask |= sampler->pins[i];
+    }
+
+    sampler->read = 0;
+    edges_init(&sampler->edges, mask, sampler_edge, sampler);
+
+    DMA_StructInit(&dma_struct);
+
+    dma_struct.DMA_Channel = SAMPLER_DMA_CHANNEL;
+    dma_struct.DMA_PeripheralBaseAddr = STATIC_CAST(uint32_t, &sampler->port->IDR);
+    dma_struct.DMA_Memory0BaseAddr = STATIC_CAST(uint32_t, sampler->buffer);
+    dma_struct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    dma_struct.DMA_BufferSize = SAMPLER_SIZE;
+    dma_struct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dma_struct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dma_struct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    dma_struct.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    dma_struct.DMA_Mode = DMA_Mode_Circular;
+    dma_struct.DMA_Priority = DMA_Priority_High;
+
+    DMA_Init(sampler->stream, &dma_struct);
+    DMA_Cmd(sampler->stream, ENABLE);
+
+    TIM_DMACmd(SAMPLER_TIMER, sampler->dma_event, ENABLE);
+}
+
+/*
+ * Configures the timer that paces the DMA transfers.
+ */
+void sampler_timer_init()
+{
+    TM_TIMER_PROPERTIES_t   timer_data;
+    TIM_TimeBaseInitTypeDef base_struct;
+    TIM_OCInitTypeDef       oc_struct;
+    uint32_t                period;
+    int_t                   i;
+
+    TM_TIMER_PROPERTIES_EnableClock(SAMPLER_TIMER);
+    TM_TIMER_PROPERTIES_GetTimerProperties(SAMPLER_TIMER, &timer_data);
+
+    period = timer_data.TimerFrequency / 1000000 * SAMPLER_PERIOD;
+
+    base_struct.TIM_Prescaler = 0;
+    base_struct.TIM_CounterMode = TIM_CounterMode_Up;
+    base_struct.TIM_Period = period - 1;
+    base_struct.TIM_ClockDivision = TIM_CKD_DIV1;
+    base_struct.TIM_RepetitionCounter = 0;
+
+    TIM_TimeBaseInit(SAMPLER_TIMER, &base_struct);
+
+    // The compare events only request the transfers of the further ports,
+    // spread over the period, no output
+    TIM_OCStructInit(&oc_struct);
+    oc_struct.TIM_OCMode = TIM_OCMode_Timing;
+
+    for(i = 1; i < sampler_ports_num; ++i)
+    {
+        oc_struct.TIM_Pulse = period * i / sampler_ports_num;
+
+        switch(sampler_requests[i].channel)
+        {
+        case TIM_Channel_1:
+            TIM_OC1Init(SAMPLER_TIMER, &oc_struct);
+            break;
+        case TIM_Channel_2:
+            TIM_OC2Init(SAMPLER_TIMER, &oc_struct);
+            break;
+        case TIM_Channel_3:
+            TIM_OC3Init(SAMPLER_TIMER, &oc_struct);
+            break;
+        }
+    }
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Starts copying the echo ports into the circular buffers, one sample each
+ * SAMPLER_PERIOD microseconds.
+ */
+void sampler_init()
+{
+    int_t i;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+
+    sampler_ports_init();
+    sampler_timer_init();
+
+    for(i = 0; i < sampler_ports_num; ++i)
+        sampler_stream_init(&sampler_ports[i]);
+
+    TIM_Cmd(SAMPLER_TIMER, ENABLE);
+}
+
+/*
+ * Scans the samples stored since the last call, forwarding the edges found on
+ * the echo lines to sensors_echo_edge.
+ */
+void sampler_process()
+{
+    sampler_port_t* sampler;
+    uint_t          write;
+    int_t           i;
+
+    for(i = 0; i < sampler_ports_num; ++i)
+    {
+        sampler = &sampler_ports[i];
+
+        // The stream counts down the transfers left before wrapping around
+        write = SAMPLER_SIZE - DMA_GetCurrDataCounter(sampler->stream);
+        if(write == SAMPLER_SIZE)
+            write = 0;
+
+        sampler->read = edges_detect_ring(&sampler->edges, sampler->buffer,
+                SAMPLER_SIZE, sampler->read, write);
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * sampler.h
+ *
+ * This file contains all declaration of public functions and constants
+ * defined in the sampler.c file.
+ *
+ * */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "types.h"
+#include "constants.h"
+
+/*
+ * Constants
+ *
+ */
+
+#define SAMPLER_PERIOD      (10)    // Interval between two samples of the
+                                    // echo ports, in microseconds
+
+#define SAMPLER_SIZE        (1024)  // Number of samples of each buffer, they
+                                    // cover SAMPLER_SIZE * SAMPLER_PERIOD
+                                    // microseconds
+
+#define SAMPLER_TASK_PERIOD (5000)  // Interval in microseconds between two
+                                    // scans of the buffers, must be less
+                                    // than the time covered by them and an
+                                    // integer multiple of SYST_PERIOD
+
+#define SAMPLER_TASK_PERIOD_TICKS (SAMPLER_TASK_PERIOD / SYST_PERIOD)
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Starts copying the echo ports into the circular buffers, one sample each
+ * SAMPLER_PERIOD microseconds.
+ */
+extern void sampler_init();
+
+/*
+ * Scans the samples stored since the last call, forwarding the edges found on
+ * the echo lines to sensors_echo_edge.
+ */
+extern void sampler_process();
+
+#endif
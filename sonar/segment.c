@@ -0,0 +1,335 @@
+/*
+ * segment.c
+ *
+ * This file contains the segmentation of the distances measured at all the
+ * bearings into objects: next bearings whose distances differ by at most
+ * SEGMENT_GAP_MAX belong to the same object.
+ *
+ * Objects are updated as each distance arrives: a bearing is removed from its
+ * object, which may be shortened or split in two, then added to the objects
+ * of the next bearings, which may be extended or merged. Only the bearings of
+ * the objects involved are visited, never the whole sweep.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "segment.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define SEGMENT_NONE    (-1)    // Label of the bearings out of any object
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Object with the sum of its distances, positions being from 0.
+ */
+typedef struct SEGMENT_STATE_STRUCT
+{
+    segment_t   object;
+    long_int_t  sum;            // Sum of the distances of all the positions
+    bool_t      used;
+} segment_state_t;
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static distance_t       segment_distances[SEGMENT_BEARINGS] =
+        { [0 ... SEGMENT_BEARINGS - 1] = SENSOR_DIST_MAX };
+static int8_t           segment_labels[SEGMENT_BEARINGS] =
+        { [0 ... SEGMENT_BEARINGS - 1] = SEGMENT_NONE };
+                                // Object of each bearing, or SEGMENT_NONE
+static segment_state_t  segment_objects[SEGMENT_MAX];
+static int_t            segment_used = 0;
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Returns a free object, whose bearings are still to be labelled.
+ */
+int_t segment_alloc()
+{
+    int_t i;
+
+    for(i = 0; i < SEGMENT_MAX; ++i)
+    {
+        if(!segment_objects[i].used)
+        {
+            segment_objects[i].used = true;
+            ++segment_used;
+
+            return i;
+        }
+    }
+
+    // Not reached, there is an object for each bearing
+    return SEGMENT_NONE;
+}
+
+/*
+ * Releases an object, whose bearings shall be already labelled otherwise.
+ */
+void segment_free(int_t id)
+{
+    segment_objects[id].used = false;
+    --segment_used;
+}
+
+/*
+ * Sets an object to the given bearings, labelling them, and computes its
+ * nearest distance and centroid.
+ */
+void segment_set(int_t id, int_t first, int_t last)
+{
+    segment_t*  object = &segment_objects[id].object;
+    long_int_t  sum = 0;
+    int_t       i;
+
+    object->first = first;
+    object->last = last;
+    object->nearest = SENSOR_DIST_MAX;
+
+    for(i = first; i <= last; ++i)
+    {
+        segment_labels[i] = id;
+        sum += segment_distances[i];
+
+        if(segment_distances[i] < object->nearest)
+            object->nearest = segment_distances[i];
+    }
+
+    segment_objects[id].sum = sum;
+}
+
+/*
+ * Adds a bearing next to the first or the last one of an object, without
+ * visiting the other ones.
+ */
+void segment_extend(int_t id, int_t pos)
+{
+    segment_t* object = &segment_objects[id].object;
+
+    if(pos < object->first)
+        object->first = pos;
+    else
+        object->last = pos;
+
+    segment_labels[pos] = id;
+    segment_objects[id].sum += segment_distances[pos];
+
+    if(segment_distances[pos] < object->nearest)
+        object->nearest = segment_distances[pos];
+}
+
+/*
+ * Removes a bearing from its object, which is shortened, split in two or
+ * released.
+ */
+void segment_remove(int_t pos)
+{
+    const int_t id = segment_labels[pos];
+    segment_t*  object;
+    int_t       first;
+    int_t       last;
+
+    if(id == SEGMENT_NONE)
+        return;
+
+    object = &segment_objects[id].object;
+    first = object->first;
+    last = object->last;
+
+    segment_labels[pos] = SEGMENT_NONE;
+
+    if(first == last)
+        segment_free(id);
+    else if(pos == first)
+        segment_set(id, first + 1, last);
+    else if(pos == last)
+        segment_set(id, first, last - 1);
+    else
+    {
+        segment_set(id, first, pos - 1);
+        segment_set(segment_alloc(), pos + 1, last);
+    }
+}
+
+/*
+ * Tells whether a bearing next to pos belongs to an object that continues at
+ * pos.
+ */
+bool_t segment_joins(int_t pos, int_t next)
+{
+    distance_t change;
+
+    if(next < 0 || next >= SEGMENT_BEARINGS || segment_labels[next] == SEGMENT_NONE)
+        return false;
+
+    change = segment_distances[pos] - segment_distances[next];
+
+    return BOOL(change <= SEGMENT_GAP_MAX && change >= -SEGMENT_GAP_MAX);
+}
+
+/*
+ * Adds a bearing to the objects next to it, creating or merging them.
+ */
+void segment_insert(int_t pos)
+{
+    const bool_t    left = segment_joins(pos, pos - 1);
+    const bool_t    right = segment_joins(pos, pos + 1);
+    int_t           lx;
+    int_t           rx;
+    int_t           i;
+
+    if(left && right)
+    {
+        lx = segment_labels[pos - 1];
+        rx = segment_labels[pos + 1];
+
+        // The bearings of the shorter object are added to the longer one
+        if(pos - segment_objects[lx].object.first < segment_objects[rx].object.last - pos)
+        {
+            segment_free(lx);
+
+            for(i = pos; i >= segment_objects[lx].object.first; --i)
+                segment_extend(rx, i);
+        } else
+        {
+            segment_free(rx);
+
+            for(i = pos; i <= segment_objects[rx].object.last; ++i)
+                segment_extend(lx, i);
+        }
+    }
+    else if(left)
+        segment_extend(segment_labels[pos - 1], pos);
+    else if(right)
+        segment_extend(segment_labels[pos + 1], pos);
+    else
+        segment_set(segment_alloc(), pos, pos);
+}
+
+/*
+ * Copies an object, with its angles and centroid.
+ */
+void segment_copy(int_t id, segment_t* object)
+{
+    const segment_state_t*  state = &segment_objects[id];
+    const int_t             count = state->object.last - state->object.first + 1;
+
+    *object = state->object;
+
+    object->first += USR_MIN_POS;
+    object->last += USR_MIN_POS;
+    object->start = GEO_POS_TO_ANGLE(object->first);
+    object->end = GEO_POS_TO_ANGLE(object->last);
+    object->angle = (object->start + object->end) / 2;
+    object->range = STATIC_CAST(distance_t, (state->sum + count / 2) / count);
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets all the distances, see segment.h.
+ */
+void segment_init()
+{
+    int_t i;
+
+    for(i = 0; i < SEGMENT_BEARINGS; ++i)
+    {
+        segment_distances[i] = SENSOR_DIST_MAX;
+        segment_labels[i] = SEGMENT_NONE;
+    }
+
+    for(i = 0; i < SEGMENT_MAX; ++i)
+        segment_objects[i].used = false;
+
+    segment_used = 0;
+}
+
+/*
+ * Sets the distance at a position, see segment.h.
+ */
+void segment_update(int_t pos, distance_t distance)
+{
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return;
+
+    pos -= USR_MIN_POS;
+
+    segment_remove(pos);
+
+    segment_distances[pos] = distance;
+
+    if(distance < SENSOR_DIST_MAX)
+        segment_insert(pos);
+}
+
+/*
+ * Returns the number of objects seen.
+ */
+int_t segment_count()
+{
+    return segment_used;
+}
+
+/*
+ * Copies all the objects, see segment.h.
+ */
+int_t segment_get_objects(segment_t objects[])
+{
+    int_t count = 0;
+    int_t i = 0;
+
+    while(i < SEGMENT_BEARINGS)
+    {
+        if(segment_labels[i] == SEGMENT_NONE)
+        {
+            ++i;
+            continue;
+        }
+
+        segment_copy(segment_labels[i], &objects[count]);
+        i = segment_objects[segment_labels[i]].object.last + 1;
+        ++count;
+    }
+
+    return count;
+}
+
+/*
+ * Copies the object at a position, see segment.h.
+ */
+bool_t segment_get(int_t pos, segment_t* object)
+{
+    if(pos < USR_MIN_POS || pos > USR_MAX_POS)
+        return false;
+
+    pos -= USR_MIN_POS;
+
+    if(segment_labels[pos] == SEGMENT_NONE)
+        return false;
+
+    segment_copy(segment_labels[pos], object);
+
+    return true;
+}
@@ -0,0 +1,88 @@
+/*
+ * segment.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the segment.c file.
+ *
+ * */
+
+#ifndef SEGMENT_H
+#define SEGMENT_H
+
+#include "types.h"
+#include "motor.h"
+#include "sensor.h"
+#include "geometry.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define SEGMENT_BEARINGS    (USR_MAX_POS + 1)
+                                    // Motor positions segmented
+
+#define SEGMENT_MAX         (SEGMENT_BEARINGS)
+                                    // Most objects, as next bearings at very
+                                    // different distances are different ones
+
+#define SEGMENT_GAP_US      (600)   // Largest change of the distance between
+                                    // next bearings of the same object, about
+                                    // 10 cm, in microseconds of echo
+#define SEGMENT_GAP_MAX     (SEGMENT_GAP_US / DISTANCE_PERIOD)
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Object seen at contiguous bearings with consistent distances.
+ */
+typedef struct SEGMENT_STRUCT
+{
+    int_t       first;          // First motor position of the object
+    int_t       last;           // Last one, not lower than first
+    int_t       start;          // Angle of the first position, see geometry.h
+    int_t       end;            // Angle of the last position
+    distance_t  nearest;        // Least distance of the object, in ticks
+    int_t       angle;          // Angle of the centroid
+    distance_t  range;          // Distance of the centroid, in ticks
+} segment_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets the distances at all the bearings, so that no object is seen.
+ */
+extern void segment_init();
+
+/*
+ * Sets the distance measured at the given motor position, updating only the
+ * objects at that position and at the ones next to it. SENSOR_DIST_MAX means
+ * that nothing is in sight there. Positions out of USR_MIN_POS..USR_MAX_POS
+ * are ignored.
+ */
+extern void segment_update(int_t pos, distance_t distance);
+
+/*
+ * Returns the number of objects seen.
+ */
+extern int_t segment_count();
+
+/*
+ * Copies the objects seen in objects, which shall hold SEGMENT_MAX of them,
+ * ordered by their first position, and returns their number.
+ */
+extern int_t segment_get_objects(segment_t objects[]);
+
+/*
+ * Copies the object seen at the given motor position. Returns false if
+ * nothing is seen there.
+ */
+extern bool_t segment_get(int_t pos, segment_t* object);
+
+#endif
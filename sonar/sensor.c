@@ -13,86 +13,139 @@
 
 #include <stdlib.h>
 
-#include "lib/tm_stm32f4_gpio.h"
+#include "hal.h"
 
 #include "constants.h"
 #include "sensor.h"
+#include "sensor_config.h"
+#include "echo_fsm.h"
+#include "fixed.h"
+#include "filter.h"
+#include "tracker.h"
+#include "alarm.h"
+#include "trigger.h"
+#include "queue.h"
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_CAPTURE
+#include "capture.h"
+#elif SENSOR_ACQ_MODE == SENSOR_ACQ_DMA
+#include "sampler.h"
+#endif
 
 /* ---------------------------
  * Private constants
  * ---------------------------
  */
 
-// Defines the GPIO ports and pins used to send trigger signals and reach echos
-#define SENSOR_LX_TRIG_PORT     (GPIOA)
-#define SENSOR_LX_TRIG_PIN      (GPIO_Pin_7)
-
-#define SENSOR_RX_TRIG_PORT     (GPIOB)
-#define SENSOR_RX_TRIG_PIN      (GPIO_Pin_15)
-
-#define SENSOR_LX_ECHO_PORT     (GPIOA)
-#define SENSOR_LX_ECHO_PIN      (GPIO_Pin_5)
-
-#define SENSOR_RX_ECHO_PORT     (GPIOB)
-#define SENSOR_RX_ECHO_PIN      (GPIO_Pin_13)
-
-
-#define SENSORS_SEPARATION_CM   (3.4)   // The separation between the two
-                                        // sensors in cm, used by the
-                                        // triangolation approximation
-#define SENSORS_SEPARATION      (SENSORS_SEPARATION_CM * 2 * 10000 / 340 / SYST_PERIOD)
+#define SENSORS_SEPARATION      (SOUND_MM_TO_US(SENSORS_SEPARATION_MM) / DISTANCE_PERIOD)
                                         // The separation between the two
                                         // sensors in number of ticks, used by
                                         // the triangolation approximation
 
-#define SENSORS_MARGIN          (0.8)   // The margin under which two objects
+#define SENSORS_MARGIN          Q15(0.8)
+                                        // The margin under which two objects
                                         // are considered to be the same
 
+#define DITHER_TOLERANCE_US     (150)   // Largest change in microseconds of
+                                        // the echo width between two triggers
+                                        // of a sensor while dithering
+#define DITHER_TOLERANCE        ECHO_US_TO_TICKS(DITHER_TOLERANCE_US)
+                                        // The same in number of ticks
+#define DITHER_SEED             (2463534242u)
+                                        // Initial state of the random delays
+
+#define SENSOR_STEP_RECORDS     (SENSORS_NUM * (SENSOR_RETURNS_MAX + 1))
+                                        // Most records of a trigger, all its
+                                        // echoes and the closing ones
+
 /* ---------------------------
  * Data types
  * ---------------------------
  */
 
-typedef uint_t          pin_t;
-typedef GPIO_TypeDef    port_t;
-
-enum sensor_id { SENSOR_LX = 0, SENSOR_RX = 1 };
-
-/*
- * Defines the possible states the sensor can be in.
- */
-typedef enum
-{
-    SENSOR_ECHO_NEXT_OK = 0,// The previous echo value was not ok, but the
-                            // following one will be hopefully good
-    SENSOR_ECHO_OK,         // Everything works as expected
-    SENSOR_ECHO_LOST,       // No echo arrived
-    SENSOR_ECHO_LONG,       // Echo is taking too long to complete
-
-} sensor_echo_state_t;
-
-
 typedef struct SENSOR_STRUCT
 {
     bool_t      trig_sent;      // Whether the trigger signal has been sent or
                                 // not
     bool_t      recording;      // Whether the sensor is waiting the end of the
                                 // echo or not
-    int_t       last_distance;  // Last calculated distance in number of ticks
-    int_t       time_counter;   // Counter used to count the number of ticks
-                                // since last start of recording
+    bool_t      more;           // Whether the sensor is waiting a further
+                                // echo of the same trigger or not
+    stamp_t     echo_start;     // Time at which the current recording started
+    stamp_t     first_start;    // Time at which the first echo started
+
+    returns_t   returns;        // Echoes of the current trigger
+    returns_t   last_returns;   // Echoes of the last completed trigger
+    distance_t  last_width;     // Width of the first echo of the previous
+                                // trigger, or -1 if it had none
+    stamp_t     raw;            // Duration of the first echo of the current
+                                // trigger before calibration
+    stamp_t     last_raw;       // The same for the last completed trigger
+    sensor_calib_t calib;       // Correction of the echo durations
 
     sensor_echo_state_t echo_state;
                                 // See the previous type definition
 
-    port_t*     echo_port;      // Echo port identifier
+    sensor_health_t health;     // States reached at the last triggers
+    uint8_t     history[SENSOR_HEALTH_WINDOW];
+                                // The same states, as a circular buffer
+    uint_t      history_next;   // Position of the oldest state in history
+
+    int_t       port;           // Index of the echo port in the ports array
     pin_t       echo_pin;       // Echo pin identifier
 } sensor_t;
 
+/*
+ * Contains the echo pins of all the sensors connected to a port, so that all
+ * of them are read at once.
+ */
+typedef struct ECHO_PORT_STRUCT
+{
+    port_t*     port;           // Echo port identifier
+    pin_t       wait_rise;      // Pins of the sensors waiting an echo to start
+    pin_t       wait_fall;      // Pins of the sensors waiting an echo to end
+} echo_port_t;
+
 typedef struct SENSOR_STATE_STRUCT
 {
-    sensor_t    sensors[2];
-    int_t     last_distance;
+    sensor_t    sensors[SENSORS_NUM];
+    echo_port_t ports[SENSORS_NUM];
+    int_t       ports_num;      // Number of ports used by the sensors
+    distance_t  last_distance;
+    distance_t  last_measured;  // The same before filtering
+    distance_t  range;          // Longest echo waited for, in number of ticks
+    int_t       returns_max;    // Echoes captured for each trigger
+    stamp_t     now;            // Time of the last sample taken by polling
+    uint32_t    steps;          // Triggers sent, the clock of the other
+                                // backends, see sensors_get_time
+
+    int_t       sampling;       // Sampling mode, see constants.h
+    bool_t      listening;      // Whether echo pins need to be sampled
+    bool_t      closed;         // Whether the listening window is closed
+    stamp_t     trigger_time;   // Time at which the last trigger was sent
+    int_t       bearing;        // Motor position for the next trigger
+    int_t       trigger_bearing;// Motor position when the last trigger was sent
+    stamp_t     close_time;     // Time at which the listening window closed
+    uint_t      samples;        // Samples taken since the last trigger
+    uint_t      step_samples;   // Samples taken during the last step
+    int_t       single;         // Only working sensor, or -1 if more of them
+                                // are used, see sensors_get_single
+    uint_t      dither;         // Longest random delay of the triggers in
+                                // microseconds, see sensors_set_dither
+    uint32_t    seed;           // State of the random delays generator
+    geo_point_t point;          // Object located at the last step
+    bool_t      located;        // Whether point is valid
+
+    // Owned by the task sending the triggers, taken from the records of the
+    // last closed trigger, see consume_measures
+    distance_t  step_distances[SENSORS_NUM];
+                                // Distance of each sensor in number of ticks
+    uint8_t     step_states[SENSORS_NUM];
+                                // State of each sensor, see sensor_echo_state_t
+    int_t       step_bearing;   // Motor position of the trigger
+    measure_t   step_records[SENSOR_STEP_RECORDS];
+    int_t       step_count;     // Records in step_records
+    int_t       step_next;      // Next record of sensors_get_measure
 } sensor_state_t;
 
 
@@ -104,15 +157,45 @@ typedef struct SENSOR_STATE_STRUCT
 #define SENSOR_INIT {\
 .trig_sent = false,\
 .recording = false,\
-.last_distance = SENSOR_DIST_MAX,\
-.time_counter = 0,\
+.more = false,\
+.last_width = -1,\
+.calib = { 0, SENSOR_CALIB_UNIT },\
+.echo_start = 0,\
+.first_start = 0,\
 .echo_state = SENSOR_ECHO_NEXT_OK,\
 }
 
+// Measures completed by the interrupt handlers, consumed by tasks
+static queue_t sensor_queue;
+
 static sensor_state_t sensor_state =
 {
     .last_distance = SENSOR_DIST_MAX,
-    .sensors = { SENSOR_INIT, SENSOR_INIT },
+    .last_measured = SENSOR_DIST_MAX,
+    .sensors = { [0 ... SENSORS_NUM - 1] = SENSOR_INIT },
+    .ports_num = 0,
+    .range = SENSOR_DIST_MAX,
+    .returns_max = SENSOR_RETURNS_DEFAULT,
+    .now = 0,
+    .steps = 0,
+    .sampling = SENSOR_SAMPLING_MODE,
+    .single = -1,
+    .dither = TRIGGER_DITHER_DEFAULT,
+    .seed = DITHER_SEED,
+    .listening = true,
+    .closed = false,
+    .trigger_time = 0,
+    .bearing = 0,
+    .trigger_bearing = 0,
+    .close_time = 0,
+    .samples = 0,
+    .step_samples = 0,
+    .located = false,
+    .step_distances = { [0 ... SENSORS_NUM - 1] = SENSOR_DIST_MAX },
+    .step_states = { [0 ... SENSORS_NUM - 1] = SENSOR_ECHO_NEXT_OK },
+    .step_bearing = 0,
+    .step_count = 0,
+    .step_next = 0,
 };
 
 /* ---------------------------
@@ -126,173 +209,570 @@ static sensor_state_t sensor_state =
  * */
 bool_t get_echo_value(sensor_t* sensor)
 {
-    return BOOL(TM_GPIO_GetInputPinValue((sensor->echo_port), (sensor->echo_pin)));
+    return BOOL(TM_GPIO_GetInputPinValue(sensor_state.ports[sensor->port].port,
+            sensor->echo_pin));
 }
 
 /*
- * Reads a sensor value, starting to count if a positive edge is encountered,
- * stopping if instead it's a negative edge.
- * As soon as it stops it updates the sensor last distance.
+ * Updates the masks of the sensor echo port, so that the pin of the sensor is
+ * watched for the edge the sensor is waiting, if any.
  * */
-void read_sensor(sensor_t* sensor)
+void watch_update(sensor_t* sensor)
 {
-    bool_t  echo_value;
+    echo_port_t* port = &sensor_state.ports[sensor->port];
 
-    echo_value = get_echo_value(sensor);
+    port->wait_rise &= ~sensor->echo_pin;
+    port->wait_fall &= ~sensor->echo_pin;
 
     if(sensor->recording)
+        port->wait_fall |= sensor->echo_pin;
+    else if(sensor->trig_sent || sensor->more)
+        port->wait_rise |= sensor->echo_pin;
+}
+
+/*
+ * Appends a record of a sensor to the measures queue: the echo with the given
+ * index since the trigger, or MEASURE_END for the record closing the trigger.
+ * */
+void push_measure(sensor_t* sensor, stamp_t stamp, distance_t distance, int_t index)
+{
+    measure_t measure;
+
+    measure.stamp       = stamp;
+    measure.distance    = distance;
+    measure.bearing     = sensor_state.trigger_bearing;
+    measure.sensor      = STATIC_CAST(uint8_t, sensor - sensor_state.sensors);
+    measure.echo_state  = STATIC_CAST(uint8_t, sensor->echo_state);
+    measure.index       = STATIC_CAST(uint8_t, index);
+
+    queue_push(&sensor_queue, &measure);
+}
+
+/*
+ * Scales a duration in microseconds by the gain of a sensor.
+ * */
+stamp_t scale(const sensor_t* sensor, stamp_t us)
+{
+    if(us > SENSOR_CALIB_US_MAX)
+        us = SENSOR_CALIB_US_MAX;
+
+    return (us * sensor->calib.gain) >> SENSOR_CALIB_SHIFT;
+}
+
+/*
+ * Corrects the duration of an echo in microseconds with the calibration of a
+ * sensor, see sensor_calib_t.
+ * */
+stamp_t calibrate(const sensor_t* sensor, stamp_t us)
+{
+    long_int_t flight = STATIC_CAST(long_int_t, us) - sensor->calib.offset;
+
+    // Echoes shorter than the latency come from no distance at all
+    if(flight <= 0)
+        return 0;
+
+    return scale(sensor, flight);
+}
+
+/*
+ * Saves an echo just ended, lasting the given microseconds, among the echoes
+ * of the current trigger. The first one is also the distance measured by the
+ * sensor.
+ * */
+void add_return(sensor_t* sensor, stamp_t stamp, stamp_t duration)
+{
+    echo_return_t* echo = &sensor->returns.echoes[sensor->returns.num];
+    stamp_t        width = ECHO_US_TO_TICKS(calibrate(sensor, duration));
+
+    if(width > SENSOR_DIST_MAX)
+        width = SENSOR_DIST_MAX;
+
+    // The first echo is the distance, compared at once with the alarm
+    if(sensor->returns.num++ == 0)
     {
-        ++sensor->time_counter;
+        sensor->raw = duration;
+        alarm_update(STATIC_CAST(int_t, sensor - sensor_state.sensors), width, true);
+    }
+
+    // The latency is the same for all the echoes, only the gain applies
+    echo->start = ECHO_US_TO_TICKS(scale(sensor, sensor->echo_start - sensor->first_start));
+    echo->width = width;
 
+    push_measure(sensor, stamp, RETURN_DISTANCE(*echo), sensor->returns.num - 1);
+
+    // Further echoes are waited for only if there is still room for them
+    sensor->more = BOOL(sensor->returns.num < sensor_state.returns_max);
+}
+
+/*
+ * Handles the echo line of a sensor seen at the given level at the given time,
+ * starting to record if a positive edge is encountered after a trigger,
+ * stopping if instead it's a negative edge.
+ * As soon as it stops it updates the sensor last distance.
+ * */
+void echo_edge(sensor_t* sensor, bool_t echo_value, stamp_t stamp)
+{
+    if(sensor->recording)
+    {
         if(!echo_value)
         {
             // I have to stop recording!
             sensor->recording = false;
 
-            // We save an echo only if it arrived at the right time
+            // We save an echo only if it arrived at the right time, its
+            // duration is an unsigned difference, valid also across a counter
+            // overflow
             if(sensor->echo_state == SENSOR_ECHO_OK || sensor->echo_state == SENSOR_ECHO_NEXT_OK)
-                sensor->last_distance = sensor->time_counter;
+                add_return(sensor, stamp, stamp - sensor->echo_start);
         }
     }
-    else if(sensor->trig_sent && echo_value)
+    else if((sensor->trig_sent || sensor->more) && echo_value)
     {
-        sensor->time_counter = 0;
+        if(sensor->trig_sent)
+            sensor->first_start = stamp;
+
+        sensor->echo_start = stamp;
         sensor->recording = true;
         sensor->trig_sent = false;
+        sensor->more = false;
     }
+
+    watch_update(sensor);
 }
 
 /*
- * Sends the trigger signal to both sensors.
+ * Reads all the echo pins of a port at once and handles only the pins that
+ * reached the level their sensor is waiting for, see the echo_edge function.
  * */
-void send_trigger()
+void read_port(echo_port_t* port)
 {
-    if(sensor_state.sensors[SENSOR_LX].echo_state != SENSOR_ECHO_LONG)
+    int_t   i;
+    pin_t   value;
+    pin_t   events;
+
+    value  = STATIC_CAST(pin_t, TM_GPIO_GetPortInputValue(port->port));
+    events = (value & port->wait_rise) | (~value & port->wait_fall);
+
+    // Most of the samples carry no edge at all
+    if(!events)
+        return;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
     {
-        TM_GPIO_SetPinHigh(SENSOR_LX_TRIG_PORT, SENSOR_LX_TRIG_PIN);
-        sensor_state.sensors[SENSOR_LX].trig_sent = true;
+        sensor_t* sensor = &sensor_state.sensors[i];
+
+        if(&sensor_state.ports[sensor->port] == port &&
+                (events & sensor->echo_pin))
+            echo_edge(sensor, BOOL(value & sensor->echo_pin), sensor_state.now);
     }
-    else
-        sensor_state.sensors[SENSOR_LX].trig_sent = false;
+}
+
+/*
+ * Lowers the proximity alarm as soon as the first echo being recorded by a
+ * sensor is longer than the threshold, without waiting for its end.
+ * */
+void watch_alarm()
+{
+    int_t i;
 
-    if(sensor_state.sensors[SENSOR_RX].echo_state != SENSOR_ECHO_LONG)
+    for(i = 0; i < SENSORS_NUM; ++i)
     {
-        TM_GPIO_SetPinHigh(SENSOR_RX_TRIG_PORT, SENSOR_RX_TRIG_PIN);
-        sensor_state.sensors[SENSOR_RX].trig_sent = true;
+        sensor_t* sensor = &sensor_state.sensors[i];
+
+        if(sensor->recording && sensor->returns.num == 0)
+            alarm_update(i, ECHO_US_TO_TICKS(calibrate(sensor,
+                    sensor_state.now - sensor->echo_start)), false);
     }
-    else
-        sensor_state.sensors[SENSOR_RX].trig_sent = false;
 }
 
 /*
- * Checks if at the moment of sending a new trigger the previous echo was
- * already finished. If not, marks the previous value as an error and
- * invalidates next record.
+ * Checks whether a sensor that already saw the start of an echo is still
+ * within the range, i.e. its echoes have to be waited for.
  * */
-void check_finished(sensor_t* sensor)
+bool_t in_range(sensor_t* sensor)
 {
-    // Since in state SENSOR_ECHO_LONG trig_sent cannot be true
-    if(sensor->echo_state == SENSOR_ECHO_LONG)
-        sensor->trig_sent = false;
+    return BOOL((sensor->recording || sensor->more) &&
+            sensor_state.now - sensor->first_start <
+            STATIC_CAST(stamp_t, sensor_state.range) * DISTANCE_PERIOD);
+}
 
-    if(sensor->recording)
+/*
+ * Checks whether the given sensor is left out by the single sensor mode, see
+ * sensors_get_single.
+ * */
+bool_t ignored(int_t id)
+{
+    return BOOL(sensor_state.single >= 0 && id != sensor_state.single);
+}
+
+/*
+ * Checks whether all sensors are done with the current listening window, that
+ * is each echo either finished, went beyond the range or timed out.
+ * */
+bool_t window_closed()
+{
+    int_t   i;
+    bool_t  timeout;
+    bool_t  waiting = false;
+
+    for(i = 0; i < sensor_state.ports_num; ++i)
     {
-        // Echo is taking too long to complete
-        sensor->echo_state = SENSOR_ECHO_LONG;
-        sensor->last_distance = SENSOR_DIST_MAX;
+        if(sensor_state.ports[i].wait_rise || sensor_state.ports[i].wait_fall)
+            waiting = true;
+    }
+
+    // Most of the samples of a closing window find nothing to wait for
+    if(!waiting)
+        return true;
 
-    } else if(sensor->trig_sent)
+    // Echoes start after the delay of their trigger
+    timeout = BOOL(sensor_state.now - sensor_state.trigger_time >=
+            STATIC_CAST(stamp_t, SENSOR_DIST_MAX) * DISTANCE_PERIOD +
+            sensor_state.dither);
+
+    for(i = 0; i < SENSORS_NUM; ++i)
     {
-        // Echo didn't arrive even if we sent a trigger
-        sensor->echo_state = SENSOR_ECHO_LOST;
-        sensor->last_distance = SENSOR_DIST_MAX;
+        // Failing sensors would keep the window open up to the timeout
+        if(ignored(i))
+            continue;
+
+        if(sensor_state.sensors[i].trig_sent && !timeout)
+            return false;
+
+        // Echoes beyond the range are not waited for, the end of a recording
+        // one will be found on the echo line by check_finished instead
+        if(in_range(&sensor_state.sensors[i]))
+            return false;
+    }
+
+    return true;
+}
 
-    } else if(sensor->echo_state == SENSOR_ECHO_LONG)
+/*
+ * Returns the next number of a xorshift sequence, enough to make the trigger
+ * delays unrelated to any other periodic source.
+ * */
+uint32_t dither_random()
+{
+    uint32_t x = sensor_state.seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    sensor_state.seed = x;
+
+    return x;
+}
+
+/*
+ * Sends the trigger signal to all sensors that are not still busy with a too
+ * long echo, each one with its own random delay if dithering.
+ * */
+void send_trigger()
+{
+    int_t   i;
+    uint_t  fired = 0;
+    uint_t  delays[SENSORS_NUM];
+
+    for(i = 0; i < SENSORS_NUM; ++i)
     {
-        // Echo finished, but it doesn't need to be considered, since indeed
-        // it's a previous echo influencing this window.
+        sensor_t* sensor = &sensor_state.sensors[i];
 
-        // Hopefully the next measurement will be fine!
+        sensor->trig_sent = ECHO_FSM_TRIGGER(sensor->echo_state);
+        fired |= sensor->trig_sent ? TRIGGER_SENSOR(i) : 0;
 
-        sensor->echo_state = SENSOR_ECHO_NEXT_OK;
-        sensor->last_distance = SENSOR_DIST_MAX;
+        delays[i] = sensor_state.dither == 0 ? 0 :
+                dither_random() % (sensor_state.dither + 1u);
 
-    } else
+        watch_update(sensor);
+    }
+
+    // All the pulses start together and end by themselves
+    trigger_fire(fired, delays);
+
+    // Opens a new listening window
+    sensor_state.trigger_time = sensor_state.now;
+    sensor_state.trigger_bearing = sensor_state.bearing;
+    sensor_state.listening = true;
+    sensor_state.closed = false;
+}
+
+/*
+ * Adds the state just reached by a sensor to its health statistics, replacing
+ * the oldest one once SENSOR_HEALTH_WINDOW states are counted.
+ * */
+void update_health(sensor_t* sensor)
+{
+    sensor_health_t*    health = &sensor->health;
+    uint8_t*            oldest = &sensor->history[sensor->history_next];
+    uint_t              failed;
+
+    if(health->outcomes == SENSOR_HEALTH_WINDOW)
+        --health->counts[*oldest];
+    else
+        ++health->outcomes;
+
+    *oldest = sensor->echo_state;
+    ++health->counts[sensor->echo_state];
+
+    sensor->history_next = (sensor->history_next + 1) % SENSOR_HEALTH_WINDOW;
+
+    // Either no echo arrived or the echo line never went low, a sensor seeing
+    // nothing still gives an echo beyond the maximum distance
+    failed = health->counts[SENSOR_ECHO_LOST] + health->counts[SENSOR_ECHO_LONG];
+
+    // Different thresholds, so that a sensor failing once in a while does not
+    // switch mode at each trigger
+    if(failed >= SENSOR_HEALTH_FAIL)
+        health->failing = true;
+    else if(failed <= SENSOR_HEALTH_RECOVER)
+        health->failing = false;
+}
+
+/*
+ * Enters the single sensor mode when all the sensors but one are failing, and
+ * leaves it as soon as another one is working again.
+ * */
+void update_single()
+{
+    int_t i;
+    int_t working = 0;
+
+    sensor_state.single = -1;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
     {
-        // The measured value is perfectly fine and can be used.
-        sensor->echo_state = SENSOR_ECHO_OK;
+        if(!sensor_state.sensors[i].health.failing)
+        {
+            sensor_state.single = i;
+            ++working;
+        }
     }
+
+    if(working != 1 || SENSORS_NUM == 1)
+        sensor_state.single = -1;
 }
 
 /*
- * Calculates the current distance measured by the system based
- * on the two distances measured by each sensor.
+ * Checks whether the first echo of the current trigger of a sensor follows
+ * its own trigger. While dithering, an echo caused by a pulse of another
+ * sensor or sonar moves with the random delay of the trigger, so its width
+ * changes from a trigger to the next, while a real echo keeps its width up to
+ * the movement of the motor. A sensor needs then two consistent echoes in a
+ * row.
+ * */
+bool_t consistent(sensor_t* sensor)
+{
+    distance_t change;
+
+    if(sensor_state.dither == 0)
+        return true;
+
+    if(sensor->last_width < 0)
+        return false;
+
+    change = sensor->returns.echoes[0].width - sensor->last_width;
+
+    return BOOL(change <= DITHER_TOLERANCE && change >= -DITHER_TOLERANCE);
+}
+
+/*
+ * Checks if at the moment of sending a new trigger the previous echo was
+ * already finished. If not, marks the previous value as an error and
+ * invalidates next record. The trigger is closed by a record carrying the
+ * state reached by the sensor and its distance.
+ * */
+void check_finished(sensor_t* sensor)
+{
+    distance_t distance = SENSOR_DIST_MAX;
+
+    // The listening window may have been closed during an echo beyond the
+    // range, if the echo line is already low the echo is over
+    if(sensor->recording && !get_echo_value(sensor))
+        sensor->recording = false;
+
+    // See echo_fsm.c for the transitions
+    sensor->echo_state = ECHO_FSM_STEP(sensor->echo_state,
+            sensor->recording, sensor->trig_sent);
+
+    // Only a perfectly fine measurement is used, if its first echo ended
+    // within the range. The echoes of the trigger are complete, no further
+    // ones are waited for.
+    if(sensor->echo_state == SENSOR_ECHO_OK && sensor->returns.num > 0 &&
+            consistent(sensor))
+    {
+        distance = sensor->returns.echoes[0].width;
+        sensor->last_returns = sensor->returns;
+        sensor->last_raw = sensor->raw;
+    } else
+        sensor->last_returns.num = 0;
+
+    push_measure(sensor, sensors_get_time(), distance, MEASURE_END);
+
+    // Reference for the consistency of the next echo
+    if(sensor->echo_state == SENSOR_ECHO_OK && sensor->returns.num > 0)
+        sensor->last_width = sensor->returns.echoes[0].width;
+    else
+        sensor->last_width = -1;
+
+    // The alarm of a sensor seeing nothing is lowered once per trigger
+    if(sensor->returns.num == 0)
+        alarm_clear(STATIC_CAST(int_t, sensor - sensor_state.sensors));
+
+    sensor->returns.num = 0;
+    sensor->more = false;
+
+    update_health(sensor);
+
+    watch_update(sensor);
+}
+
+/*
+ * Calculates the current distance measured by the system based on the
+ * distances measured by the given number of sensors.
+ * The nearest object is taken as reference: the distances that are close
+ * enough to it are considered measures of the same object and averaged,
+ * farther ones are other objects and ignored.
  */
-int_t triangolation(int_t dist_lx, int_t dist_rx)
+distance_t triangolation(const distance_t distances[], int_t count)
 {
-    int_t distance;
+    int_t       i;
+    distance_t  nearest;
+    long_int_t  sum;
+    int_t       num;
+    long_int_t  same;
 
-    if(dist_lx < 0)
-        dist_lx = 0;
+    nearest = SENSOR_DIST_MAX;
 
-    if(dist_rx < 0)
-        dist_rx = 0;
+    for(i = 0; i < count; ++i)
+    {
+        if(distances[i] < nearest)
+            nearest = distances[i] < 0 ? 0 : distances[i];
+    }
 
-    if(dist_lx >= SENSOR_DIST_MAX && dist_rx >= SENSOR_DIST_MAX )
+    if(nearest >= SENSOR_DIST_MAX)
     {
         // No objects in sight
-        distance = SENSOR_DIST_MAX;
-    } else
+        return SENSOR_DIST_MAX;
+    }
+
+    sum = 0;
+    num = 0;
+    same = Q15_MUL(SENSORS_SEPARATION, SENSORS_MARGIN);
+
+    for(i = 0; i < count; ++i)
     {
-        // At least one object is in sight
-        if (abs(dist_lx-dist_rx)> SENSORS_SEPARATION*SENSORS_MARGIN)
-        {
-            // There are multiple objects in sight
-            distance = (dist_lx < dist_rx) ? dist_lx : dist_rx;
-        } else
+        distance_t distance = distances[i] < 0 ? 0 : distances[i];
+
+        // Only sensors seeing the same object are merged
+        if(distance - nearest <= same)
         {
-            // There is only a single object in sight
-            distance = (dist_lx + dist_rx) / 2;
+            sum += distance;
+            ++num;
         }
     }
 
-    return distance;
+    return STATIC_CAST(distance_t, sum / num);
 }
 
 /*
  * Calculates the current distance measured by the system based
- * on the two sensors states and their measured distances.
+ * on the sensors states and their measured distances.
  */
-int_t current_distance()
+distance_t current_distance()
 {
-    int_t distance;
+    int_t       i;
+    int_t       count;
+    distance_t  distances[SENSORS_NUM];
 
-    // NOTICE: If both sensors skipped the last measurement, they both measured
-    // SENSOR_DIST_MAX
+    // A single working sensor needs no fusion, its distance is already
+    // SENSOR_DIST_MAX if it skipped the last measurement
+    if(sensor_state.single >= 0)
+        return sensor_state.step_distances[sensor_state.single];
 
-    if(sensor_state.sensors[SENSOR_LX].echo_state != SENSOR_ECHO_OK)
-    {
-        distance = sensor_state.sensors[SENSOR_RX].last_distance;
-        return distance > SENSOR_DIST_MAX ? SENSOR_DIST_MAX : distance;
-    }
+    // NOTICE: Sensors that skipped the last measurement are not considered,
+    // if all of them skipped it nothing is in sight
+    count = 0;
 
-    if(sensor_state.sensors[SENSOR_RX].echo_state != SENSOR_ECHO_OK)
+    for(i = 0; i < SENSORS_NUM; ++i)
     {
-        distance = sensor_state.sensors[SENSOR_LX].last_distance;
-        return distance > SENSOR_DIST_MAX ? SENSOR_DIST_MAX : distance;
+        if(sensor_state.step_states[i] == SENSOR_ECHO_OK)
+            distances[count++] = sensor_state.step_distances[i];
     }
 
-    return triangolation(sensor_state.sensors[SENSOR_LX].last_distance,
-            sensor_state.sensors[SENSOR_RX].last_distance);
+    return triangolation(distances, count);
 }
 
 /*
- * Updates the distance based on the values read by both sensors.
+ * Updates the distance based on the values read by both sensors, filtered with
+ * the previous ones at the same bearing, see filter.c. The track of that
+ * bearing is corrected with the distance before the moving average, as the
+ * tracker smooths it by itself, but without the spurious ones, see tracker.c.
  */
 void update_distance()
 {
-    sensor_state.last_distance = SENSORS_MARGIN*current_distance() +
-            (1-SENSORS_MARGIN)*sensor_state.last_distance;
+    distance_t distance = current_distance();
+
+    sensor_state.last_measured = distance;
+    sensor_state.last_distance = filter_update(sensor_state.step_bearing, distance);
+
+    tracker_update(sensor_state.step_bearing, filter_get_robust(), sensors_get_time());
+}
+
+/*
+ * Locates the object seen by both the left and the right sensor at the trigger
+ * just completed, see geometry.c.
+ */
+void update_point()
+{
+    const distance_t lx = sensor_state.step_distances[SENSOR_LX];
+    const distance_t rx = sensor_state.step_distances[SENSOR_RX];
+
+    sensor_state.located = BOOL(sensor_state.single < 0 &&
+            lx < SENSOR_DIST_MAX && rx < SENSOR_DIST_MAX);
+
+    if(sensor_state.located)
+        geo_locate(DISTANCE_TO_MM(lx), DISTANCE_TO_MM(rx),
+                sensor_state.step_bearing, &sensor_state.point);
+}
+
+/*
+ * Pops the records of the trigger just closed from the measures queue, up to
+ * the closing one of each sensor, and keeps them for sensors_get_measure. The
+ * distance and the state of each sensor are taken from its closing record, a
+ * sensor whose record was dropped skipped the measurement.
+ */
+void consume_measures(int_t bearing)
+{
+    measure_t   record;
+    int_t       closed = 0;
+    int_t       i;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        sensor_state.step_distances[i] = SENSOR_DIST_MAX;
+        sensor_state.step_states[i] = SENSOR_ECHO_LOST;
+    }
+
+    sensor_state.step_bearing = bearing;
+    sensor_state.step_count = 0;
+    sensor_state.step_next = 0;
+
+    // Echoes of the next trigger are left to the next step
+    while(closed < SENSORS_NUM && queue_pop(&sensor_queue, &record))
+    {
+        if(sensor_state.step_count < SENSOR_STEP_RECORDS)
+            sensor_state.step_records[sensor_state.step_count++] = record;
+
+        if(record.index != MEASURE_END)
+            continue;
+
+        sensor_state.step_distances[record.sensor] = record.distance;
+        sensor_state.step_states[record.sensor] = record.echo_state;
+        sensor_state.step_bearing = record.bearing;
+        ++closed;
+    }
 }
 
 /* ---------------------------
@@ -302,79 +782,387 @@ void update_distance()
 
 void sensors_init()
 {
-    // Saving all the sensors parameters
-    sensor_state.sensors[SENSOR_LX].echo_port   = SENSOR_LX_ECHO_PORT;
-    sensor_state.sensors[SENSOR_LX].echo_pin    = SENSOR_LX_ECHO_PIN;
-
-    sensor_state.sensors[SENSOR_RX].echo_port   = SENSOR_RX_ECHO_PORT;
-    sensor_state.sensors[SENSOR_RX].echo_pin    = SENSOR_RX_ECHO_PIN;
-
-    // Ports and pins initialization
-    TM_GPIO_Init(SENSOR_LX_TRIG_PORT,
-                SENSOR_LX_TRIG_PIN,
-                TM_GPIO_Mode_OUT,
-                TM_GPIO_OType_PP,
-                TM_GPIO_PuPd_NOPULL,
-                TM_GPIO_Speed_High);
-
-    TM_GPIO_Init(SENSOR_RX_TRIG_PORT,
-                SENSOR_RX_TRIG_PIN,
-                TM_GPIO_Mode_OUT,
-                TM_GPIO_OType_PP,
-                TM_GPIO_PuPd_NOPULL,
-                TM_GPIO_Speed_High);
-
-    TM_GPIO_Init(SENSOR_LX_ECHO_PORT,
-                SENSOR_LX_ECHO_PIN,
-                TM_GPIO_Mode_IN,
-                TM_GPIO_OType_PP,
-                TM_GPIO_PuPd_NOPULL,
-                TM_GPIO_Speed_High);
-
-    TM_GPIO_Init(SENSOR_RX_ECHO_PORT,
-                SENSOR_RX_ECHO_PIN,
-                TM_GPIO_Mode_IN,
-                TM_GPIO_OType_PP,
-                TM_GPIO_PuPd_NOPULL,
-                TM_GPIO_Speed_High);
-}
-
-/*
- * Reads both sensors value, see the read_sensor function.
+    int_t i;
+    int_t j;
+
+    sensor_state.ports_num = 0;
+
+    queue_init(&sensor_queue);
+    sensor_state.step_count = 0;
+    sensor_state.step_next = 0;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        // Sensors sharing an echo port share also its entry in the ports array
+        for(j = 0; j < sensor_state.ports_num; ++j)
+        {
+            if(sensor_state.ports[j].port == sensor_pins[i].echo_port)
+                break;
+        }
+
+        if(j == sensor_state.ports_num)
+        {
+            sensor_state.ports[j].port      = sensor_pins[i].echo_port;
+            sensor_state.ports[j].wait_rise = 0;
+            sensor_state.ports[j].wait_fall = 0;
+            ++sensor_state.ports_num;
+        }
+
+        // Saving all the sensors parameters
+        sensor_state.sensors[i].port        = j;
+        sensor_state.sensors[i].echo_pin    = sensor_pins[i].echo_pin;
+        sensor_state.sensors[i].calib       = sensor_calib[i];
+
+        // Health statistics start over
+        sensor_state.sensors[i].health.outcomes = 0;
+        sensor_state.sensors[i].health.failing  = false;
+        sensor_state.sensors[i].history_next    = 0;
+
+        for(j = 0; j < SENSOR_ECHO_STATES; ++j)
+            sensor_state.sensors[i].health.counts[j] = 0;
+
+        watch_update(&sensor_state.sensors[i]);
+
+        // Echo pins initialization, trigger pins belong to the trigger timer
+        TM_GPIO_Init(sensor_pins[i].echo_port,
+                    sensor_pins[i].echo_pin,
+                    TM_GPIO_Mode_IN,
+                    TM_GPIO_OType_PP,
+                    TM_GPIO_PuPd_NOPULL,
+                    TM_GPIO_Speed_High);
+    }
+
+    sensor_state.single = -1;
+    sensor_state.located = false;
+
+    filter_init();
+    tracker_init();
+    alarm_init();
+
+    trigger_init();
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_CAPTURE
+    // Echo pins are then handed over to the capture timer
+    capture_init();
+#elif SENSOR_ACQ_MODE == SENSOR_ACQ_DMA
+    // Echo ports are then copied by the DMA
+    sampler_init();
+#endif
+}
+
+/*
+ * Reads all sensors value, one port at a time, see the read_port function.
  * */
 void sensors_read()
 {
-    read_sensor(&sensor_state.sensors[SENSOR_LX]);
-    read_sensor(&sensor_state.sensors[SENSOR_RX]);
+    int_t i;
+
+    sensor_state.now += SYST_PERIOD;
+
+    if(!sensor_state.listening)
+        return;
+
+    ++sensor_state.samples;
+
+    for(i = 0; i < sensor_state.ports_num; ++i)
+        read_port(&sensor_state.ports[i]);
+
+    // Only a raised alarm needs the running echoes
+    if(alarm_is_on())
+        watch_alarm();
+
+    if(!sensor_state.closed && window_closed())
+    {
+        sensor_state.closed = true;
+        sensor_state.close_time = sensor_state.now;
+    }
+
+    if(sensor_state.sampling == SENSOR_SAMPLING_GATED)
+        sensor_state.listening = !sensor_state.closed;
+}
+
+/*
+ * Selects whether sensors_read samples the echo pins on each call or only
+ * while the sensors are listening for an echo.
+ */
+void sensors_set_sampling(int_t mode)
+{
+    sensor_state.sampling = mode;
+
+    // Sampling restarts immediately, gating resumes after the next sample
+    sensor_state.listening = true;
 }
 
 /*
- * Sends the trigger signal. At the moment of sending the trigger it also
- * updates the global calculated distance at the previous step.
+ * Returns the number of calls of sensors_read that sampled the echo pins
+ * during the last completed step.
  */
-void sensors_send_trigger()
+uint_t sensors_get_step_samples()
 {
-    check_finished(&sensor_state.sensors[SENSOR_LX]);
-    check_finished(&sensor_state.sensors[SENSOR_RX]);
+    return sensor_state.step_samples;
+}
 
-    update_distance();
+/*
+ * Tells whether the next step can start, see sensor.h.
+ */
+bool_t sensors_step_ready()
+{
+    stamp_t elapsed = sensor_state.now - sensor_state.trigger_time;
+    int_t   i;
 
-    send_trigger();
+    // The fixed step period is still the upper bound, in case an echo line is
+    // stuck high
+    if(elapsed >= STEP_PERIOD)
+        return true;
+
+    // The servo moves at most once per PWM frame
+    if(elapsed < STEP_MIN || !sensor_state.closed)
+        return false;
+
+    // A single working sensor has no echoes of the others to let fade
+    if(sensor_state.single < 0 &&
+            sensor_state.now - sensor_state.close_time < STEP_GUARD)
+        return false;
+
+    // A sensor still sending an echo beyond the range ignores the trigger
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        if(!ignored(i) && sensor_state.sensors[i].recording &&
+                get_echo_value(&sensor_state.sensors[i]))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Sets the range of the sensors, see sensor.h.
+ */
+void sensors_set_range(distance_t range)
+{
+    if(range < 1)
+        range = 1;
+
+    if(range > SENSOR_DIST_MAX)
+        range = SENSOR_DIST_MAX;
+
+    sensor_state.range = range;
+}
+
+/*
+ * Returns the range of the sensors, in number of ticks.
+ */
+distance_t sensors_get_range()
+{
+    return sensor_state.range;
+}
+
+/*
+ * Notifies an edge on the echo line of the given sensor, seen at the given
+ * time. Used by edge driven backends (see capture.c) instead of sensors_read.
+ */
+void sensors_echo_edge(int_t id, bool_t level, stamp_t stamp)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return;
+
+    echo_edge(&sensor_state.sensors[id], level, stamp);
+}
+
+/*
+ * Sets the maximum number of echoes captured for each trigger, see sensor.h.
+ */
+void sensors_set_returns(int_t max)
+{
+    if(max < 1)
+        max = 1;
+
+    if(max > SENSOR_RETURNS_MAX)
+        max = SENSOR_RETURNS_MAX;
+
+    sensor_state.returns_max = max;
+}
+
+/*
+ * Returns the state of the given sensor after the last completed trigger.
+ */
+sensor_echo_state_t sensors_get_state(int_t id)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return SENSOR_ECHO_LOST;
+
+    return sensor_state.sensors[id].echo_state;
+}
+
+/*
+ * Copies the echoes of the last completed trigger, see sensor.h.
+ */
+bool_t sensors_get_returns(int_t id, returns_t* returns)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return false;
+
+    *returns = sensor_state.sensors[id].last_returns;
+
+    return BOOL(returns->num > 0);
+}
+
+/*
+ * Copies the health statistics of the given sensor, see sensor.h.
+ */
+bool_t sensors_get_health(int_t id, sensor_health_t* health)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return false;
+
+    *health = sensor_state.sensors[id].health;
+
+    return true;
+}
+
+/*
+ * Returns the only working sensor, see sensor.h.
+ */
+int_t sensors_get_single()
+{
+    return sensor_state.single;
+}
+
+/*
+ * Sets the calibration of the given sensor, see sensor.h.
+ */
+void sensors_set_calibration(int_t id, const sensor_calib_t* calib)
+{
+    sensor_calib_t* dest;
+
+    if(id < 0 || id >= SENSORS_NUM)
+        return;
+
+    dest = &sensor_state.sensors[id].calib;
+    *dest = *calib;
+
+    if(dest->gain < SENSOR_CALIB_UNIT / 2)
+        dest->gain = SENSOR_CALIB_UNIT / 2;
+
+    if(dest->gain > SENSOR_CALIB_UNIT * 2)
+        dest->gain = SENSOR_CALIB_UNIT * 2;
+}
+
+/*
+ * Copies the uncalibrated duration of the last first echo, see sensor.h.
+ */
+bool_t sensors_get_raw_width(int_t id, stamp_t* width)
+{
+    if(id < 0 || id >= SENSORS_NUM)
+        return false;
+
+    *width = sensor_state.sensors[id].last_raw;
+
+    return BOOL(sensor_state.sensors[id].last_returns.num > 0);
+}
+
+/*
+ * Sets the longest random delay of the triggers, see sensor.h.
+ */
+void sensors_set_dither(uint_t max)
+{
+    if(max > TRIGGER_DITHER_MAX)
+        max = TRIGGER_DITHER_MAX;
+
+    sensor_state.dither = max;
+}
+
+/*
+ * Sets the motor position to be attached to the measures of the next trigger.
+ */
+void sensors_set_bearing(int_t bearing)
+{
+    sensor_state.bearing = bearing;
 }
 
 /*
- * Stops the trigger signal.
+ * Copies the object located at the last step, see sensor.h.
  */
-void sensors_stop_trigger()
+bool_t sensors_get_point(geo_point_t* point)
 {
-    TM_GPIO_SetPinLow(SENSOR_LX_TRIG_PORT, SENSOR_LX_TRIG_PIN);
-    TM_GPIO_SetPinLow(SENSOR_RX_TRIG_PORT, SENSOR_RX_TRIG_PIN);
+    if(!sensor_state.located)
+        return false;
+
+    *point = sensor_state.point;
+
+    return true;
+}
+
+/*
+ * Copies the next record of the last closed trigger, see sensor.h.
+ */
+bool_t sensors_get_measure(measure_t* measure)
+{
+    if(sensor_state.step_next >= sensor_state.step_count)
+        return false;
+
+    *measure = sensor_state.step_records[sensor_state.step_next++];
+
+    return true;
+}
+
+/*
+ * Sends the trigger signal. At the moment of sending the trigger it also
+ * updates the global calculated distance at the previous step, from the
+ * records of the trigger just closed.
+ */
+void sensors_send_trigger()
+{
+    const int_t bearing = sensor_state.trigger_bearing;
+    int_t       i;
+
+    // The sensors are owned by the interrupt handlers, which must not see
+    // them while the trigger is closed and the next one sent
+    HAL_SUSPEND();
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+        check_finished(&sensor_state.sensors[i]);
+
+    update_single();
+
+    sensor_state.step_samples = sensor_state.samples;
+    sensor_state.samples = 0;
+    ++sensor_state.steps;
+
+    send_trigger();
+
+    HAL_RESUME();
+
+    consume_measures(bearing);
+    update_distance();
+    update_point();
 }
 
 /*
  * Returns the last calculated distance.
  * */
-int_t sensors_get_last_distance()
+distance_t sensors_get_last_distance()
 {
     return sensor_state.last_distance;
 }
+
+/*
+ * Returns the last calculated distance before filtering, see sensor.h.
+ * */
+distance_t sensors_get_last_measured()
+{
+    return sensor_state.last_measured;
+}
+
+/*
+ * Returns the current time, see sensor.h.
+ */
+stamp_t sensors_get_time()
+{
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_POLLING
+    return sensor_state.now;
+#else
+    // Steps are then always STEP_PERIOD apart, see constants.h
+    return sensor_state.steps * STEP_PERIOD;
+#endif
+}
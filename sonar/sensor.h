@@ -11,18 +11,169 @@
 
 #include "types.h"
 #include "constants.h"
+#include "sound.h"
+#include "geometry.h"
 
 /*
  * Constants
  *
  */
 
-#define SENSOR_DIST_MAX (41200 / SYST_PERIOD)
+/*
+ * Distances are measured as echo durations, in number of ticks of
+ * DISTANCE_PERIOD microseconds. By default a tick is a systick period and
+ * distances fit in an int_t, with a resolution of about 8.5 mm. Defining
+ * __SENSOR_HIRES__ (e.g. with an EE_OPT in conf.oil) gives a microsecond tick,
+ * about 0.17 mm, stored in a long_int_t. It is meant for the edge driven
+ * backends, since polling still sees edges once every SYST_PERIOD.
+ */
+#if defined(__SENSOR_HIRES__)
+#define DISTANCE_PERIOD (1)
+typedef long_int_t  distance_t;
+#else
+#define DISTANCE_PERIOD SYST_PERIOD
+typedef int_t       distance_t;
+#endif
+
+#define SENSOR_DIST_MAX (41200 / DISTANCE_PERIOD)
                     // Maximum distance in number of ticks
                     // about 7 meters
 
 // FIXME: this is a test with 5 meters
-// #define SENSOR_DIST_MAX (29430 / SYST_PERIOD)
+// #define SENSOR_DIST_MAX (29430 / DISTANCE_PERIOD)
+
+#define SENSOR_RETURNS_MAX (4)
+                    // Maximum number of echoes captured for each trigger
+
+/*
+ * Number of echoes captured for each trigger by default, see
+ * sensors_set_returns. Sensors like the HY-SRF05 give a single echo, others
+ * can give one echo for each object in sight.
+ */
+#if defined(__SENSOR_MULTI_ECHO__)
+#define SENSOR_RETURNS_DEFAULT  SENSOR_RETURNS_MAX
+#else
+#define SENSOR_RETURNS_DEFAULT  (1)
+#endif
+
+/*
+ * Identifiers of the sensors connected to the board, their pins are listed in
+ * sensor_config.c.
+ */
+enum sensor_id { SENSOR_LX = 0, SENSOR_RX = 1, SENSORS_NUM };
+
+/*
+ * Defines the possible states the sensor can be in.
+ */
+typedef enum
+{
+    SENSOR_ECHO_NEXT_OK = 0,// The previous echo value was not ok, but the
+                            // following one will be hopefully good
+    SENSOR_ECHO_OK,         // Everything works as expected
+    SENSOR_ECHO_LOST,       // No echo arrived
+    SENSOR_ECHO_LONG,       // Echo is taking too long to complete
+
+    SENSOR_ECHO_STATES,     // Number of states, see echo_fsm.h
+} sensor_echo_state_t;
+
+/*
+ * Health statistics of a sensor, i.e. the states it reached at the last
+ * SENSOR_HEALTH_WINDOW triggers. A sensor giving no echo or a never ending one
+ * at most of them is failing, see sensors_get_single.
+ */
+#define SENSOR_HEALTH_WINDOW    (32)
+                    // Number of triggers the statistics refer to
+#define SENSOR_HEALTH_FAIL      (SENSOR_HEALTH_WINDOW * 3 / 4)
+                    // Failed triggers after which a sensor is failing
+#define SENSOR_HEALTH_RECOVER   (SENSOR_HEALTH_WINDOW / 4)
+                    // Failed triggers under which it is working again
+
+typedef struct SENSOR_HEALTH_STRUCT
+{
+    uint_t      outcomes;       // Triggers counted, up to SENSOR_HEALTH_WINDOW
+    uint_t      counts[SENSOR_ECHO_STATES];
+                                // Number of those triggers ending in each
+                                // state, see sensor_echo_state_t
+    bool_t      failing;        // Whether the sensor is persistently failing
+} sensor_health_t;
+
+/*
+ * Calibration of a sensor, applied to each echo duration in microseconds
+ * before its conversion to a distance: the latency offset is subtracted and
+ * the result is multiplied by gain / SENSOR_CALIB_UNIT. See calib.h to obtain
+ * it from measures of known distances and sensor_config.c for the stored ones.
+ */
+#define SENSOR_CALIB_SHIFT  (12)
+#define SENSOR_CALIB_UNIT   (1 << SENSOR_CALIB_SHIFT)
+                    // Gain of a sensor that needs no correction
+#define SENSOR_CALIB_US_MAX (2 * SENSOR_DIST_MAX * DISTANCE_PERIOD)
+                    // Longest echo duration calibrated in microseconds, twice
+                    // the maximum distance, so that the gain never overflows
+
+typedef struct SENSOR_CALIB_STRUCT
+{
+    int_t       offset;         // Latency of the echo in microseconds
+    uint_t      gain;           // Scale of the echo, SENSOR_CALIB_UNIT is 1
+} sensor_calib_t;
+
+/*
+ * Timestamp of an echo edge, in microseconds of a free running 32 bit counter.
+ * Differences between timestamps are valid even across a counter overflow.
+ */
+typedef uint32_t    stamp_t;
+
+/*
+ * A single echo measured by a sensor.
+ */
+typedef struct MEASURE_STRUCT
+{
+    stamp_t     stamp;          // Time at which the echo ended
+    distance_t  distance;       // Measured distance in number of ticks
+    int_t       bearing;        // Motor position when the trigger was sent
+    uint8_t     sensor;         // Identifier of the sensor, see sensor_id
+    uint8_t     echo_state;     // State of the sensor, see sensor_echo_state_t
+    uint8_t     index;          // Number of the echo since the trigger, or
+                                // MEASURE_END
+} measure_t;
+
+/*
+ * Index of the record closing the trigger of a sensor, once per trigger after
+ * all its echoes. It holds the state reached by the sensor and the distance it
+ * measured, SENSOR_DIST_MAX if the measurement is not valid, stamped when the
+ * trigger was closed.
+ */
+#define MEASURE_END (0xFF)
+
+/*
+ * A single echo captured by a sensor, in number of ticks.
+ */
+typedef struct ECHO_RETURN_STRUCT
+{
+    distance_t  start;          // Time from the start of the first echo of the
+                                // same trigger to the start of this one
+    distance_t  width;          // Duration of the echo
+} echo_return_t;
+
+/*
+ * Distance of an echo in number of ticks, i.e. the time from the start of the
+ * first echo to the end of this one. For the first echo it is its width.
+ */
+#define RETURN_DISTANCE(ret) ((ret).start + (ret).width)
+
+/*
+ * All the echoes captured by a sensor for a single trigger, nearest first.
+ */
+typedef struct RETURNS_STRUCT
+{
+    int_t           num;        // Number of echoes captured
+    echo_return_t   echoes[SENSOR_RETURNS_MAX];
+} returns_t;
+
+/*
+ * Converts an echo width in microseconds to the nearest number of ticks.
+ */
+#define ECHO_US_TO_TICKS(us) \
+    (((us) + DISTANCE_PERIOD / 2) / DISTANCE_PERIOD)
 
 /* ---------------------------
  * Public functions
@@ -32,10 +183,120 @@
 extern void sensors_init();
 
 /*
- * Reads both sensors value, see the read_sensor function.
+ * Reads all sensors value, one port at a time, see the read_port function.
  */
 extern void sensors_read();
 
+/*
+ * Selects whether sensors_read samples the echo pins on each call or only
+ * while the sensors are listening for an echo (SENSOR_SAMPLING_ALWAYS or
+ * SENSOR_SAMPLING_GATED, see constants.h).
+ */
+extern void sensors_set_sampling(int_t mode);
+
+/*
+ * Returns the number of calls of sensors_read that sampled the echo pins
+ * during the last completed step, i.e. between the last two triggers.
+ */
+extern uint_t sensors_get_step_samples();
+
+/*
+ * Tells whether the next step can start, that is at least STEP_MIN
+ * microseconds passed since the last trigger, all its echoes completed or
+ * timed out at least STEP_GUARD microseconds ago and all the echo lines are
+ * low, or STEP_PERIOD microseconds passed since the trigger. Used when
+ * STEP_MODE is STEP_MODE_ADAPTIVE, see constants.h.
+ */
+extern bool_t sensors_step_ready();
+
+/*
+ * Sets the range of the sensors, in number of ticks (see CM_TO_DISTANCE),
+ * limited to SENSOR_DIST_MAX. Echoes longer than the range are not waited
+ * for, so that the listening window closes earlier, and are reported as
+ * SENSOR_DIST_MAX.
+ */
+extern void sensors_set_range(distance_t range);
+
+/*
+ * Returns the range of the sensors, in number of ticks.
+ */
+extern distance_t sensors_get_range();
+
+/*
+ * Notifies an edge on the echo line of the given sensor, seen at the given
+ * time. Used by edge driven backends (see capture.c) instead of sensors_read.
+ */
+extern void sensors_echo_edge(int_t id, bool_t level, stamp_t stamp);
+
+/*
+ * Sets the maximum number of echoes captured for each trigger, limited to
+ * SENSOR_RETURNS_MAX. After the first echo the sensors keep listening for the
+ * following ones up to the range, see sensors_set_range.
+ */
+extern void sensors_set_returns(int_t max);
+
+/*
+ * Returns the state of the given sensor after the last completed trigger.
+ */
+extern sensor_echo_state_t sensors_get_state(int_t id);
+
+/*
+ * Copies the echoes captured by the given sensor for the last completed
+ * trigger. Returns false, with no echoes, if its measurement was not valid.
+ */
+extern bool_t sensors_get_returns(int_t id, returns_t* returns);
+
+/*
+ * Copies the health statistics of the given sensor. Returns false if the
+ * identifier is not valid.
+ */
+extern bool_t sensors_get_health(int_t id, sensor_health_t* health);
+
+/*
+ * Returns the identifier of the only sensor still working when all the others
+ * are failing, or -1 if the sensors are used together. In this single sensor
+ * mode the failing sensors are not waited for, the distance is the one of the
+ * working sensor and the step does not wait STEP_GUARD.
+ */
+extern int_t sensors_get_single();
+
+/*
+ * Sets the calibration of the given sensor, its gain is limited between half
+ * and twice SENSOR_CALIB_UNIT. Sensors start with the calibration stored in
+ * sensor_config.c.
+ */
+extern void sensors_set_calibration(int_t id, const sensor_calib_t* calib);
+
+/*
+ * Copies the duration in microseconds, before calibration, of the first echo
+ * of the given sensor for the last completed trigger. Returns false if its
+ * measurement was not valid.
+ */
+extern bool_t sensors_get_raw_width(int_t id, stamp_t* width);
+
+/*
+ * Sets the longest random delay, in microseconds, added to the trigger of each
+ * sensor (see trigger_fire), 0 disables the dithering. While dithering, the
+ * first echo of a sensor is used only if its width is close to the one of the
+ * previous trigger: echoes of the other sensors or of other sonars move with
+ * the random delays, so they are rejected.
+ */
+extern void sensors_set_dither(uint_t max);
+
+/*
+ * Sets the motor position to be attached to the measures of the next trigger.
+ * This is the position commanded with the trigger, the servo reaches it up to
+ * MOTOR_SETTLE_US later, see motor.h.
+ */
+extern void sensors_set_bearing(int_t bearing);
+
+/*
+ * Copies the position of the object located by the left and the right sensor
+ * at the last completed trigger, see geo_locate. Returns false if any of them
+ * did not see it.
+ */
+extern bool_t sensors_get_point(geo_point_t* point);
+
 /*
  * Sends the trigger signal. At the moment of sending the trigger it also
  * updates the global calculated distance at the previous step.
@@ -43,29 +304,57 @@ extern void sensors_read();
 extern void sensors_send_trigger();
 
 /*
- * Stops the trigger signal.
+ * Returns the last calculated distance, filtered with the previous ones at the
+ * same bearing, see filter.h.
  */
-extern void sensors_stop_trigger();
+extern distance_t sensors_get_last_distance();
 
 /*
- * Returns the last calculated distance.
+ * Returns the last calculated distance as measured, before any filter. It
+ * follows a change in a single step, for the consumers comparing the visits
+ * of a bearing, see change.h and background.h.
  */
-extern int_t sensors_get_last_distance();
+extern distance_t sensors_get_last_measured();
 
+/*
+ * Returns the current time in microseconds, the one of the distances passed
+ * to the tracker (see tracker.h). Polling keeps it with each sample, the other
+ * backends with each trigger.
+ */
+extern stamp_t sensors_get_time();
 
-// NOTICE: The following macros may overflow if the receiver container is not a
-// lont_int_t variable.
-#define DISTANCE_TO_CM(val) \
-    (STATIC_CAST(long_int_t,val) * 340 * SYST_PERIOD / 2 / 10000)
-
-// NOTICE: the maximum resolution of the system is the centimeter, because
-// otherwise the screen is no more able to keep up with the overload.
+/*
+ * Copies the next record of the last closed trigger, in order: the echoes of
+ * each sensor and its closing record, see MEASURE_END. Returns false once all
+ * of them were copied. Records are produced by the interrupt handlers that see
+ * the echoes and consumed by sensors_send_trigger, which computes the distance
+ * of the step from them, so they are read by the same task.
+ */
+extern bool_t sensors_get_measure(measure_t* measure);
 
 
-#define DISTANCE_TO_MM(val) \
-    (STATIC_CAST(long_int_t,val) * 340 * SYST_PERIOD / 2 / 1000)
+/*
+ * Conversions between distances and lengths at the speed of sound in use, see
+ * sound.h. They only need a multiplication and a shift, the divisions by
+ * powers of ten are by constants.
+ */
 #define DISTANCE_TO_UM(val) \
-    (STATIC_CAST(long_int_t,val) * 340 * SYST_PERIOD / 2)
+    STATIC_CAST(long_int_t, SOUND_US_TO_UM(STATIC_CAST(uint32_t,val) * DISTANCE_PERIOD))
+#define DISTANCE_TO_MM(val) (DISTANCE_TO_UM(val) / 1000)
+#define DISTANCE_TO_CM(val) (DISTANCE_TO_UM(val) / 10000)
+
+// NOTICE: the screen shows distances in mm, see gui_set_obstacle, which is
+// finer than the resolution of the default build.
+
+
+// Converts a distance in cm to the nearest greater number of ticks, up to the
+// rounding of the speed of sound tables
+#define CM_TO_DISTANCE(cm) \
+    STATIC_CAST(long_int_t, (SOUND_MM_TO_US(STATIC_CAST(uint32_t,cm) * 10) + DISTANCE_PERIOD - 1) / DISTANCE_PERIOD)
+
+// Longest distance in mm at any temperature, a constant for initializers
+#define SENSOR_DIST_MAX_MM \
+    (STATIC_CAST(long_int_t,SENSOR_DIST_MAX) * DISTANCE_PERIOD * SOUND_SPEED_MAX / 2 / 1000)
 
 #endif
 
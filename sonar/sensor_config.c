@@ -0,0 +1,42 @@
+/*
+ * sensor_config.c
+ *
+ * This file contains the table describing how each sensor is connected to the
+ * board. To add a sensor, add its identifier in sensor.h and its pins here.
+ * Calibrations obtained with calib_fit are stored here as well.
+ *
+ * */
+
+#include "sensor_config.h"
+
+const sensor_pins_t sensor_pins[SENSORS_NUM] =
+{
+    [SENSOR_LX] =
+    {
+        .trig_port = GPIOA,
+        .trig_pin  = GPIO_Pin_7,
+        .echo_port = GPIOA,
+        .echo_pin  = GPIO_Pin_5,
+    },
+    [SENSOR_RX] =
+    {
+        .trig_port = GPIOB,
+        .trig_pin  = GPIO_Pin_15,
+        .echo_port = GPIOB,
+        .echo_pin  = GPIO_Pin_13,
+    },
+};
+
+const sensor_calib_t sensor_calib[SENSORS_NUM] =
+{
+    [SENSOR_LX] =
+    {
+        .offset = 0,
+        .gain   = SENSOR_CALIB_UNIT,
+    },
+    [SENSOR_RX] =
+    {
+        .offset = 0,
+        .gain   = SENSOR_CALIB_UNIT,
+    },
+};
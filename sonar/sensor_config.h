@@ -0,0 +1,54 @@
+/*
+ * sensor_config.h
+ *
+ * This file contains the declaration of the table describing how each sensor
+ * is connected to the board, defined in the sensor_config.c file.
+ *
+ * */
+
+#ifndef SENSOR_CONFIG_H
+#define SENSOR_CONFIG_H
+
+#include "hal.h"
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define SENSORS_SEPARATION_MM   (34)    // The separation between two adjacent
+                                        // sensors in mm
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+typedef uint16_t        pin_t;
+typedef GPIO_TypeDef    port_t;
+
+/*
+ * Contains the GPIO ports and pins used to send the trigger signal to a sensor
+ * and to read its echo.
+ */
+typedef struct SENSOR_PINS_STRUCT
+{
+    port_t* trig_port;      // Trigger port identifier
+    pin_t   trig_pin;       // Trigger pin identifier
+    port_t* echo_port;      // Echo port identifier
+    pin_t   echo_pin;       // Echo pin identifier
+} sensor_pins_t;
+
+/*
+ * The pins of all the sensors, indexed by sensor identifier.
+ */
+extern const sensor_pins_t sensor_pins[SENSORS_NUM];
+
+/*
+ * The calibration of all the sensors, indexed by sensor identifier.
+ */
+extern const sensor_calib_t sensor_calib[SENSORS_NUM];
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * sound.c
+ *
+ * This file contains the speed of sound used to convert echo durations into
+ * distances, compensated for the air temperature measured by the thermometer
+ * (see thermo.h).
+ *
+ * The speed is 20.05 * sqrt(T + 273.15) m/s, with T in Celsius degrees. It is
+ * precomputed for each degree in a table, together with its inverse, so that
+ * the conversions only need a multiplication and a shift.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "thermo.h"
+#include "sound.h"
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+// Speed of sound at each degree from SOUND_TEMP_MIN to SOUND_TEMP_MAX
+static const sound_t sound_table[SOUND_TEMP_MAX - SOUND_TEMP_MIN + 1] =
+{
+    { 40833, 25680 }, { 40914, 25629 }, { 40994, 25579 }, { 41074, 25529 },  // -20 .. -17
+    { 41155, 25479 }, { 41234, 25430 }, { 41314, 25380 }, { 41394, 25332 },  // -16 .. -13
+    { 41473, 25283 }, { 41553, 25235 }, { 41632, 25187 }, { 41711, 25139 },  // -12 .. -9
+    { 41790, 25092 }, { 41869, 25044 }, { 41947, 24998 }, { 42026, 24951 },  // -8 .. -5
+    { 42104, 24905 }, { 42182, 24858 }, { 42260, 24813 }, { 42338, 24767 },  // -4 .. -1
+    { 42416, 24722 }, { 42493, 24676 }, { 42571, 24631 }, { 42648, 24587 },  // 0 .. 3
+    { 42725, 24542 }, { 42802, 24498 }, { 42879, 24454 }, { 42956, 24411 },  // 4 .. 7
+    { 43032, 24367 }, { 43109, 24324 }, { 43185, 24281 }, { 43261, 24238 },  // 8 .. 11
+    { 43337, 24196 }, { 43413, 24153 }, { 43489, 24111 }, { 43565, 24069 },  // 12 .. 15
+    { 43640, 24028 }, { 43716, 23986 }, { 43791, 23945 }, { 43866, 23904 },  // 16 .. 19
+    { 43941, 23863 }, { 44016, 23823 }, { 44091, 23782 }, { 44165, 23742 },  // 20 .. 23
+    { 44240, 23702 }, { 44314, 23662 }, { 44388, 23623 }, { 44462, 23583 },  // 24 .. 27
+    { 44536, 23544 }, { 44610, 23505 }, { 44684, 23466 }, { 44758, 23428 },  // 28 .. 31
+    { 44831, 23389 }, { 44905, 23351 }, { 44978, 23313 }, { 45051, 23275 },  // 32 .. 35
+    { 45124, 23238 }, { 45197, 23200 }, { 45270, 23163 }, { 45343, 23126 },  // 36 .. 39
+    { 45415, 23089 }, { 45488, 23052 }, { 45560, 23015 }, { 45632, 22979 },  // 40 .. 43
+    { 45704, 22943 }, { 45776, 22907 }, { 45848, 22871 }, { 45920, 22835 },  // 44 .. 47
+    { 45992, 22799 }, { 46063, 22764 }, { 46135, 22729 }, { 46206, 22694 },  // 48 .. 51
+    { 46277, 22659 }, { 46348, 22624 }, { 46419, 22589 }, { 46490, 22555 },  // 52 .. 55
+    { 46561, 22521 }, { 46632, 22486 }, { 46702, 22452 }, { 46773, 22419 },  // 56 .. 59
+    { 46843, 22385 }   // 60
+};
+
+/* ---------------------------
+ * Global variables
+ * ---------------------------
+ */
+
+const sound_t* sound_current = &sound_table[SOUND_TEMP_DEFAULT - SOUND_TEMP_MIN];
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Sets the speed of sound at the given temperature, see sound.h.
+ */
+void sound_set_temperature(int_t celsius)
+{
+    if(celsius < SOUND_TEMP_MIN)
+        celsius = SOUND_TEMP_MIN;
+
+    if(celsius > SOUND_TEMP_MAX)
+        celsius = SOUND_TEMP_MAX;
+
+    // A single store, so that a conversion never sees half an update
+    sound_current = &sound_table[celsius - SOUND_TEMP_MIN];
+}
+
+/*
+ * Returns the temperature of the speed of sound in use, see sound.h.
+ */
+int_t sound_get_temperature()
+{
+    return STATIC_CAST(int_t, sound_current - sound_table) + SOUND_TEMP_MIN;
+}
+
+/*
+ * Reads the thermometer and sets the speed of sound, see sound.h.
+ */
+void sound_update()
+{
+    sound_set_temperature(thermo_read());
+}
@@ -0,0 +1,89 @@
+/*
+ * sound.h
+ *
+ * This file contains all declaration of public functions and global variables
+ * defined in the sound.c file.
+ *
+ * */
+
+#ifndef SOUND_H
+#define SOUND_H
+
+#include "types.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define SOUND_TEMP_MIN      (-20)   // Range of the compensated temperatures in
+#define SOUND_TEMP_MAX      (60)    // Celsius degrees, others are clamped
+#define SOUND_TEMP_DEFAULT  (15)    // Temperature until the first reading,
+                                    // about 340 m/s
+
+#define SOUND_SPEED_MAX     (366)   // Speed in m/s at SOUND_TEMP_MAX
+
+#define SOUND_SPEED_SHIFT   (8)     // Fractional bits of sound_t speed
+#define SOUND_PACE_SHIFT    (12)    // Fractional bits of sound_t pace
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Contains the speed of sound at a temperature, in fixed point.
+ */
+typedef struct SOUND_STRUCT
+{
+    uint16_t    speed;      // Micrometers to an object for each microsecond
+                            // of echo, that is half the speed in m/s
+    uint16_t    pace;       // Microseconds of echo for each millimeter to an
+                            // object
+} sound_t;
+
+/* ---------------------------
+ * Global variables
+ * ---------------------------
+ */
+
+/*
+ * Speed of sound in use, changed only by sound_set_temperature.
+ */
+extern const sound_t* sound_current;
+
+/*
+ * Conversions between echo durations and distances at the speed of sound in
+ * use. Durations up to 90 ms and distances up to 100 m do not overflow.
+ */
+#define SOUND_US_TO_UM(us) \
+    ((STATIC_CAST(uint32_t,us) * sound_current->speed) >> SOUND_SPEED_SHIFT)
+
+// Rounds to the nearest greater number of microseconds
+#define SOUND_MM_TO_US(mm) \
+    ((STATIC_CAST(uint32_t,mm) * sound_current->pace + (1u << SOUND_PACE_SHIFT) - 1) >> SOUND_PACE_SHIFT)
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Sets the speed of sound at the given temperature in Celsius degrees,
+ * clamped to SOUND_TEMP_MIN..SOUND_TEMP_MAX.
+ */
+extern void sound_set_temperature(int_t celsius);
+
+/*
+ * Returns the temperature of the speed of sound in use.
+ */
+extern int_t sound_get_temperature();
+
+/*
+ * Reads the temperature from the thermometer and sets the speed of sound
+ * accordingly. The reading takes some microseconds, so it shall be done by a
+ * low priority task.
+ */
+extern void sound_update();
+
+#endif
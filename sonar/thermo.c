@@ -0,0 +1,89 @@
+/*
+ * thermo.c
+ *
+ * This file contains the reading of the air temperature, used to compensate
+ * the speed of sound (see sound.c), from the temperature sensor internal to
+ * the STM32F4, connected to channel 16 of ADC1.
+ *
+ * The sensor measures the temperature of the die, which is close to the one of
+ * the air as long as the board does not heat up. Its voltage is 0.76 V at
+ * 25 Celsius degrees and grows by 2.5 mV each degree, the ADC reference is the
+ * 3 V supply of the Discovery board.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "stm32f4xx_adc.h"
+
+#include "thermo.h"
+
+/* ---------------------------
+ * Private constants
+ * ---------------------------
+ */
+
+#define THERMO_ADC          (ADC1)
+
+#define THERMO_VREF_MV      (3000)  // ADC reference in millivolts
+#define THERMO_V25_MV       (760)   // Sensor voltage at 25 degrees
+#define THERMO_SLOPE_UV     (2500)  // Sensor microvolts for each degree
+
+#define THERMO_ADC_BITS     (12)
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Configures ADC1 for single software started conversions of the temperature
+ * sensor, see thermo.h.
+ */
+void thermo_init()
+{
+    ADC_CommonInitTypeDef   common_struct;
+    ADC_InitTypeDef         adc_struct;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, ENABLE);
+
+    // 84 MHz / 4, within the 36 MHz limit of the ADC clock
+    ADC_CommonStructInit(&common_struct);
+    common_struct.ADC_Prescaler = ADC_Prescaler_Div4;
+    ADC_CommonInit(&common_struct);
+
+    ADC_StructInit(&adc_struct);
+    adc_struct.ADC_Resolution = ADC_Resolution_12b;
+    adc_struct.ADC_ContinuousConvMode = DISABLE;
+    adc_struct.ADC_ExternalTrigConvEdge = ADC_ExternalTrigConvEdge_None;
+    adc_struct.ADC_DataAlign = ADC_DataAlign_Right;
+    adc_struct.ADC_NbrOfConversion = 1;
+    ADC_Init(THERMO_ADC, &adc_struct);
+
+    // The sensor needs at least 10 us of sampling, 480 cycles are about 23 us
+    ADC_RegularChannelConfig(THERMO_ADC, ADC_Channel_TempSensor, 1, ADC_SampleTime_480Cycles);
+
+    ADC_TempSensorVrefintCmd(ENABLE);
+    ADC_Cmd(THERMO_ADC, ENABLE);
+}
+
+/*
+ * Converts the temperature once, see thermo.h.
+ */
+int_t thermo_read()
+{
+    long_int_t  uv;
+
+    ADC_SoftwareStartConv(THERMO_ADC);
+
+    while(ADC_GetFlagStatus(THERMO_ADC, ADC_FLAG_EOC) == RESET)
+        ;
+
+    uv = (STATIC_CAST(long_int_t, ADC_GetConversionValue(THERMO_ADC)) * THERMO_VREF_MV
+            >> THERMO_ADC_BITS) * 1000;
+
+    return STATIC_CAST(int_t, 25 + (uv - THERMO_V25_MV * 1000L) / THERMO_SLOPE_UV);
+}
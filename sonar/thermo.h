@@ -0,0 +1,30 @@
+/*
+ * thermo.h
+ *
+ * This file contains all declaration of public functions defined in the
+ * thermo.c file.
+ *
+ * */
+
+#ifndef THERMO_H
+#define THERMO_H
+
+#include "types.h"
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Configures the ADC reading the internal temperature sensor.
+ */
+extern void thermo_init();
+
+/*
+ * Converts the temperature once and returns it in Celsius degrees, waiting
+ * for the end of the conversion (about 25 microseconds).
+ */
+extern int_t thermo_read();
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * tracker.c
+ *
+ * This file contains the alpha-beta trackers of the objects seen at each
+ * bearing. Each motor position is measured again only once per sweep, so the
+ * last distance measured there can be a full sweep old: each track keeps the
+ * range and its rate, so that the range can be predicted at any time.
+ *
+ * The first two distances of an object give its range and rate. Then at each
+ * new distance the range is predicted at its time and corrected by a fixed
+ * part of the difference, and the rate by a part of the difference over the
+ * time elapsed. Ranges are kept with TRACKER_SHIFT fractional bits.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "tracker.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define TRACKER_SHIFT   (4)     // Fractional bits of the ranges and rates
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * State of the tracker at a bearing.
+ */
+typedef struct TRACKER_STRUCT
+{
+    long_int_t  range;          // Distance at stamp, in ticks
+    long_int_t  rate;           // Change of the distance, in ticks per second
+    stamp_t     stamp;          // Time of the last distance
+    uint8_t     seen;           // Distances of the object seen, up to 2, or
+                                // 0 if no object is tracked
+} tracker_t;
+
+/* ---------------------------
+ * Private variables
+ * ---------------------------
+ */
+
+static tracker_t tracker_states[TRACKER_BEARINGS];
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Predicts the range of a track at the given time. Returns false if the track
+ * is older than TRACKER_STALE_US.
+ */
+bool_t tracker_predict(const tracker_t* state, stamp_t now, long_int_t* range)
+{
+    stamp_t     age = now - state->stamp;
+    long_int_t  seconds;
+
+    if(age > TRACKER_STALE_US)
+        return false;
+
+    // Milliseconds are enough, a bearing is measured once per step at most
+    seconds = STATIC_CAST(long_int_t, age / 1000) * Q16_ONE / 1000;
+
+    *range = state->range + Q16_MUL(state->rate, seconds);
+
+    return true;
+}
+
+/*
+ * Starts tracking a new object at the given range.
+ */
+void tracker_restart(tracker_t* state, long_int_t range, stamp_t stamp)
+{
+    state->range = range;
+    state->rate = 0;
+    state->stamp = stamp;
+    state->seen = 1;
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets all the tracks, see tracker.h.
+ */
+void tracker_init()
+{
+    int_t i;
+
+    for(i = 0; i < TRACKER_BEARINGS; ++i)
+        tracker_states[i].seen = 0;
+}
+
+/*
+ * Corrects the track of a bearing with a new distance, see tracker.h.
+ */
+void tracker_update(int_t bearing, distance_t distance, stamp_t stamp)
+{
+    const long_int_t    jump = STATIC_CAST(long_int_t, TRACKER_JUMP_MAX) << TRACKER_SHIFT;
+    const long_int_t    rate_max = STATIC_CAST(long_int_t, TRACKER_RATE_MAX) << TRACKER_SHIFT;
+    tracker_t*          state;
+    long_int_t          measured;
+    long_int_t          predicted;
+    long_int_t          residual;
+    long_int_t          elapsed;
+    long_int_t          rate;
+
+    if(bearing < USR_MIN_POS || bearing > USR_MAX_POS)
+        return;
+
+    state = &tracker_states[bearing - USR_MIN_POS];
+
+    if(distance >= SENSOR_DIST_MAX)
+    {
+        state->seen = 0;
+        return;
+    }
+
+    measured = STATIC_CAST(long_int_t, distance) << TRACKER_SHIFT;
+
+    if(state->seen == 0 || !tracker_predict(state, stamp, &predicted))
+    {
+        tracker_restart(state, measured, stamp);
+        return;
+    }
+
+    residual = measured - predicted;
+    elapsed = STATIC_CAST(long_int_t, (stamp - state->stamp) / 1000);
+
+    // The second distance gives the rate, unless the object is too fast
+    if(state->seen == 1 && elapsed > 0)
+    {
+        rate = residual * 1000 / elapsed;
+
+        if(rate <= rate_max && rate >= -rate_max)
+        {
+            state->range = measured;
+            state->rate = rate;
+            state->stamp = stamp;
+            state->seen = 2;
+            return;
+        }
+    }
+
+    // A distance too far from the prediction belongs to another object
+    if(residual > jump || residual < -jump)
+    {
+        tracker_restart(state, measured, stamp);
+        return;
+    }
+
+    state->range = predicted + Q16_MUL(residual, TRACKER_ALPHA);
+    state->stamp = stamp;
+
+    // Two distances at the same time tell nothing about the rate
+    if(elapsed == 0)
+        return;
+
+    state->rate += Q16_MUL(residual, TRACKER_BETA) * 1000 / elapsed;
+
+    if(state->rate > rate_max)
+        state->rate = rate_max;
+    else if(state->rate < -rate_max)
+        state->rate = -rate_max;
+}
+
+/*
+ * Predicts the track of a bearing, see tracker.h.
+ */
+bool_t tracker_get(int_t bearing, stamp_t now, track_t* track)
+{
+    const tracker_t*    state;
+    long_int_t          range;
+
+    track->range = SENSOR_DIST_MAX;
+    track->rate = 0;
+
+    if(bearing < USR_MIN_POS || bearing > USR_MAX_POS)
+        return false;
+
+    state = &tracker_states[bearing - USR_MIN_POS];
+
+    if(state->seen == 0 || !tracker_predict(state, now, &range))
+        return false;
+
+    // The object can not be predicted out of sight
+    range = (range + (1L << (TRACKER_SHIFT - 1))) >> TRACKER_SHIFT;
+
+    if(range < 0)
+        range = 0;
+    else if(range > SENSOR_DIST_MAX - 1)
+        range = SENSOR_DIST_MAX - 1;
+
+    track->range = STATIC_CAST(distance_t, range);
+    track->rate = (state->rate + (1L << (TRACKER_SHIFT - 1))) >> TRACKER_SHIFT;
+
+    return true;
+}
@@ -0,0 +1,87 @@
+/*
+ * tracker.h
+ *
+ * This file contains all declaration of public functions and data types
+ * defined in the tracker.c file.
+ *
+ * */
+
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include "types.h"
+#include "fixed.h"
+#include "constants.h"
+#include "motor.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define TRACKER_BEARINGS    (USR_MAX_POS + 1)
+                                    // Motor positions with their own track
+
+#define TRACKER_ALPHA       Q16(0.5)
+                                    // Part of the difference from the
+                                    // prediction added to the range
+#define TRACKER_BETA        Q16(0.1667)
+                                    // Part of the same difference, over the
+                                    // time since the last distance, added to
+                                    // the rate: alpha^2 / (2 - alpha) gives
+                                    // the least error on a steady motion
+
+#define TRACKER_JUMP_US     (1800)  // Largest difference from the prediction,
+                                    // about 30 cm, in microseconds of echo:
+                                    // beyond it a new object is tracked
+#define TRACKER_JUMP_MAX    (TRACKER_JUMP_US / DISTANCE_PERIOD)
+
+#define TRACKER_RATE_US     (12000) // Largest rate, about 2 m/s, in
+                                    // microseconds of echo per second
+#define TRACKER_RATE_MAX    (TRACKER_RATE_US / DISTANCE_PERIOD)
+
+#define TRACKER_STALE_US    (4L * USR_RANGE * STEP_PERIOD)
+                                    // Age after which a track is forgotten,
+                                    // two full sweeps
+
+/* ---------------------------
+ * Data types
+ * ---------------------------
+ */
+
+/*
+ * Estimate of the object seen at a bearing.
+ */
+typedef struct TRACK_STRUCT
+{
+    distance_t  range;          // Distance in number of ticks
+    long_int_t  rate;           // Change of the distance in number of ticks
+                                // per second, positive while moving away
+} track_t;
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Forgets the tracks at all the bearings.
+ */
+extern void tracker_init();
+
+/*
+ * Corrects the track at the given bearing with a distance measured at the
+ * given time, in microseconds. SENSOR_DIST_MAX, nothing in sight, drops the
+ * track. Distances at bearings out of USR_MIN_POS..USR_MAX_POS are ignored.
+ */
+extern void tracker_update(int_t bearing, distance_t distance, stamp_t stamp);
+
+/*
+ * Predicts the track at the given bearing at the given time, from the last
+ * distance measured there and the rate. Returns false, with range
+ * SENSOR_DIST_MAX and no rate, if no object is tracked at that bearing.
+ */
+extern bool_t tracker_get(int_t bearing, stamp_t now, track_t* track);
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * trigger.c
+ *
+ * This file contains the generation of the trigger signal of the sensors. An
+ * advanced timer runs in one pulse mode, so that each time it is started it
+ * lowers each trigger pin after the given number of microseconds and then stops
+ * by itself: the pins are forced high when the timer starts and each channel
+ * forces its pin low on its own compare match.
+ *
+ * Both trigger pins are complementary outputs of TIM1: the left one (PA7) is
+ * TIM1_CH1N, the right one (PB15) is TIM1_CH3N. Since only the complementary
+ * output of each channel is enabled, it follows its reference signal directly.
+ *
+ * */
+
+/* ---------------------------
+ * Includes
+ * ---------------------------
+ */
+
+#include "lib/tm_stm32f4_gpio.h"
+#include "lib/tm_stm32f4_timer_properties.h"
+
+#include "sensor.h"
+#include "sensor_config.h"
+#include "trigger.h"
+
+/* ---------------------------
+ * Private constants
+ * ---------------------------
+ */
+
+#define TRIGGER_TIMER       (TIM1)
+#define TRIGGER_AF          (GPIO_AF_TIM1)
+#define TRIGGER_FREQUENCY   (1000000)   // One timer tick each microsecond
+
+// Each further sensor needs its own channel in trigger_channels, otherwise it
+// would share the channel of the left one
+#if SENSORS_NUM != 2
+#error "The trigger timer drives only the left and the right sensor"
+#endif
+
+// Timer channel driving the trigger pin of each sensor, see sensor_config.c
+static const uint16_t trigger_channels[SENSORS_NUM] =
+{
+    [SENSOR_LX] = TIM_Channel_1,
+    [SENSOR_RX] = TIM_Channel_3,
+};
+
+/* ---------------------------
+ * Private functions
+ * ---------------------------
+ */
+
+/*
+ * Sets the compare value of a channel, at which its output is forced low.
+ */
+void trigger_set_compare(uint16_t channel, uint32_t value)
+{
+    switch(channel)
+    {
+    case TIM_Channel_1:
+        TIM_SetCompare1(TRIGGER_TIMER, value);
+        break;
+    case TIM_Channel_2:
+        TIM_SetCompare2(TRIGGER_TIMER, value);
+        break;
+    case TIM_Channel_3:
+        TIM_SetCompare3(TRIGGER_TIMER, value);
+        break;
+    case TIM_Channel_4:
+        TIM_SetCompare4(TRIGGER_TIMER, value);
+        break;
+    }
+}
+
+/*
+ * Configures the complementary output of a channel, forced low until the next
+ * trigger.
+ */
+void trigger_channel_init(uint16_t channel)
+{
+    TIM_OCInitTypeDef oc_struct;
+
+    TIM_OCStructInit(&oc_struct);
+
+    oc_struct.TIM_OCMode = TIM_ForcedAction_InActive;
+    oc_struct.TIM_OutputState = TIM_OutputState_Disable;
+    oc_struct.TIM_OutputNState = TIM_OutputNState_Enable;
+    oc_struct.TIM_Pulse = TRIGGER_PULSE;
+    oc_struct.TIM_OCNPolarity = TIM_OCNPolarity_High;
+    oc_struct.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+
+    switch(channel)
+    {
+    case TIM_Channel_1:
+        TIM_OC1Init(TRIGGER_TIMER, &oc_struct);
+        break;
+    case TIM_Channel_2:
+        TIM_OC2Init(TRIGGER_TIMER, &oc_struct);
+        break;
+    case TIM_Channel_3:
+        TIM_OC3Init(TRIGGER_TIMER, &oc_struct);
+        break;
+    case TIM_Channel_4:
+        TIM_OC4Init(TRIGGER_TIMER, &oc_struct);
+        break;
+    }
+}
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Configures the trigger timer in one pulse mode at 1 MHz, see trigger.h.
+ */
+void trigger_init()
+{
+    TM_TIMER_PROPERTIES_t   timer_data;
+    TIM_TimeBaseInitTypeDef base_struct;
+    int_t                   i;
+
+    TM_TIMER_PROPERTIES_EnableClock(TRIGGER_TIMER);
+    TM_TIMER_PROPERTIES_GetTimerProperties(TRIGGER_TIMER, &timer_data);
+
+    base_struct.TIM_Prescaler = timer_data.TimerFrequency / TRIGGER_FREQUENCY - 1;
+    base_struct.TIM_CounterMode = TIM_CounterMode_Up;
+    base_struct.TIM_Period = TRIGGER_PULSE;
+    base_struct.TIM_ClockDivision = TIM_CKD_DIV1;
+    base_struct.TIM_RepetitionCounter = 0;
+
+    TIM_TimeBaseInit(TRIGGER_TIMER, &base_struct);
+    TIM_SelectOnePulseMode(TRIGGER_TIMER, TIM_OPMode_Single);
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        trigger_channel_init(trigger_channels[i]);
+
+        TM_GPIO_InitAlternate(sensor_pins[i].trig_port,
+                    sensor_pins[i].trig_pin,
+                    TM_GPIO_OType_PP,
+                    TM_GPIO_PuPd_NOPULL,
+                    TM_GPIO_Speed_High,
+                    TRIGGER_AF);
+    }
+
+    // Outputs of advanced timers need also the main output enable
+    TIM_CtrlPWMOutputs(TRIGGER_TIMER, ENABLE);
+}
+
+/*
+ * Sends a single pulse to the given set of sensors, see trigger.h.
+ */
+void trigger_fire(uint_t sensors, const uint_t delays[SENSORS_NUM])
+{
+    int_t   i;
+    uint_t  end;
+    uint_t  period = TRIGGER_PULSE;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        if(!(sensors & TRIGGER_SENSOR(i)))
+            continue;
+
+        end = TRIGGER_PULSE + (delays[i] > TRIGGER_DITHER_MAX ?
+                TRIGGER_DITHER_MAX : delays[i]);
+
+        if(end > period)
+            period = end;
+
+        // The pin rises now and falls on the compare match
+        TIM_SelectOCxM(TRIGGER_TIMER, trigger_channels[i], TIM_ForcedAction_Active);
+        trigger_set_compare(trigger_channels[i], end);
+        TIM_SelectOCxM(TRIGGER_TIMER, trigger_channels[i], TIM_OCMode_Inactive);
+    }
+
+    // In one pulse mode the counter stops by itself at the end of the period
+    TIM_SetCounter(TRIGGER_TIMER, 0);
+    TIM_SetAutoreload(TRIGGER_TIMER, period);
+    TIM_Cmd(TRIGGER_TIMER, ENABLE);
+}
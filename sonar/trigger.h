@@ -0,0 +1,58 @@
+/*
+ * trigger.h
+ *
+ * This file contains all declaration of public functions defined in the
+ * trigger.c file.
+ *
+ * */
+
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "types.h"
+#include "sensor.h"
+
+/* ---------------------------
+ * Constants
+ * ---------------------------
+ */
+
+#define TRIGGER_PULSE   (15)    // Duration of the trigger pulse in
+                                // microseconds, sensors need at least 10
+
+#define TRIGGER_DITHER_MAX (2000)
+                                // Longest delay in microseconds of the end
+                                // of the pulse of a sensor, see trigger_fire
+
+/*
+ * Longest random delay of the triggers by default, see sensors_set_dither.
+ * Defining __TRIGGER_DITHER__ enables the dithering.
+ */
+#if defined(__TRIGGER_DITHER__)
+#define TRIGGER_DITHER_DEFAULT  TRIGGER_DITHER_MAX
+#else
+#define TRIGGER_DITHER_DEFAULT  (0)
+#endif
+
+// Bit of a sensor in the set of sensors to be triggered
+#define TRIGGER_SENSOR(id) (1u << (id))
+
+/* ---------------------------
+ * Public functions
+ * ---------------------------
+ */
+
+/*
+ * Configures the trigger timer and hands the trigger pins over to it.
+ */
+extern void trigger_init();
+
+/*
+ * Sends a single pulse to the given set of sensors (see TRIGGER_SENSOR), the
+ * pulse ends by itself without any further call. All the pulses start at once,
+ * the one of each sensor lasts TRIGGER_PULSE plus its delay in microseconds,
+ * up to TRIGGER_DITHER_MAX. Sensors send their burst at the end of the pulse.
+ */
+extern void trigger_fire(uint_t sensors, const uint_t delays[SENSORS_NUM]);
+
+#endif
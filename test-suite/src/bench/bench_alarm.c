@@ -0,0 +1,99 @@
+#include <stdio.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "alarm.h"
+#include "sim.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Proximity Alarm Simulation
+ * --------------------------------------------------------------------------------
+ *
+ * Compares, in simulated time, the latency of the proximity alarm raised from
+ * the polling path with the one of the distance shown by the task chain, from
+ * the end of the echo of objects within the threshold. The end of an echo is
+ * seen by the first sample after it, up to SYST_PERIOD later, while the
+ * distance is given by the next trigger and drawn by TaskGui up to
+ * SCREEN_PERIOD after that. Prints also the time taken by the samples while
+ * the alarm is raised, which follow the running echoes.
+ */
+
+#define ALARM_CM        (30)    // Threshold of the alarm
+#define ALARM_STEPS     (100)   // Steps simulated for the time of the samples
+#define ECHO_DELAY      (10)    // Ticks from the trigger to the echo start
+
+// Converts a distance in cm to the width of its echo in ticks
+#define CM_TO_TICKS(cm) (STATIC_CAST(long_int_t, cm) * 2 * 10000 / 340 / SYST_PERIOD)
+
+// Returns the nanoseconds taken by each sample with the given echo widths
+static double alarm_sample_time(int_t lx, int_t rx)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, lx }, { ECHO_DELAY, rx } };
+    uint64_t    start;
+    int_t       i;
+
+    sim_polling_step(echoes);
+
+    start = bench_now_ns();
+    for(i = 0; i < ALARM_STEPS; ++i)
+        sim_polling_step(echoes);
+
+    return STATIC_CAST(double, bench_now_ns() - start) / ALARM_STEPS / STEP_PERIOD_TICKS;
+}
+
+void bench_alarm()
+{
+    static const int_t distances[] = { 5, 10, 20, 30 };
+    sim_echo_t  echoes[SENSORS_NUM];
+    stamp_t     alarm_us;
+    stamp_t     chain_us;
+    stamp_t     alarm_worst = 0;
+    stamp_t     chain_worst = 0;
+    int_t       raised;
+    int_t       width;
+    int_t       i;
+
+    alarm_init();
+    alarm_set_threshold(CM_TO_DISTANCE(ALARM_CM));
+
+    printf("Proximity alarm: worst latency in us from the end of the echo, threshold %d cm\n", ALARM_CM);
+    printf("%10s %10s %10s\n", "cm", "alarm", "tasks");
+
+    for(i = 0; i < sizeof(distances) / sizeof(distances[0]); ++i)
+    {
+        width = CM_TO_TICKS(distances[i]);
+
+        echoes[SENSOR_LX].delay = ECHO_DELAY;
+        echoes[SENSOR_LX].width = width;
+        echoes[SENSOR_RX] = echoes[SENSOR_LX];
+
+        // Starts from the alarm lowered
+        alarm_clear(SENSOR_LX);
+        alarm_clear(SENSOR_RX);
+
+        raised = sim_alarm_step(echoes);
+
+        alarm_us = STATIC_CAST(stamp_t, raised - ECHO_DELAY - width + 1) * SYST_PERIOD;
+        chain_us = STATIC_CAST(stamp_t, STEP_PERIOD_TICKS - ECHO_DELAY - width) * SYST_PERIOD +
+                SCREEN_PERIOD;
+
+        alarm_worst = alarm_us > alarm_worst ? alarm_us : alarm_worst;
+        chain_worst = chain_us > chain_worst ? chain_us : chain_worst;
+
+        printf("%10d %10u %10u\n", distances[i], alarm_us, chain_us);
+    }
+
+    printf("%10s %10u %10u\n", "worst", alarm_worst, chain_worst);
+
+    printf("%20s %12s %12s\n", "ns/sample", "lowered", "raised");
+    printf("%20s %12.3f %12.3f\n", "",
+            alarm_sample_time(CM_TO_TICKS(2 * ALARM_CM), CM_TO_TICKS(2 * ALARM_CM)),
+            alarm_sample_time(CM_TO_TICKS(ALARM_CM / 2), CM_TO_TICKS(2 * ALARM_CM)));
+    printf("\n");
+
+    alarm_init();
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+
+#include "types.h"
+
+#include "edges.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                           Block Edge Detection Benchmark
+ * --------------------------------------------------------------------------------
+ *
+ * Compares the block edge detection with a detection that checks each line on
+ * each sample, as read_sensor does, on a buffer holding one echo per line.
+ */
+
+#define EDGES_SAMPLES   (1024)
+#define EDGES_RUNS      (20000)
+
+#define PIN_LX          (0x0020)
+#define PIN_RX          (0x2000)
+
+static uint16_t samples[EDGES_SAMPLES];
+static volatile uint32_t edges_found;
+
+static void edges_count(void* data, uint16_t pin, bool_t level, uint32_t index)
+{
+    ++edges_found;
+}
+
+// Checks each line on each sample, branching on every one of them
+static void edges_per_sample(const uint16_t* s, uint_t count, uint16_t* last)
+{
+    static const uint16_t pins[] = { PIN_LX, PIN_RX };
+    uint_t  i;
+    int_t   line;
+
+    for(i = 0; i < count; ++i)
+    {
+        for(line = 0; line < 2; ++line)
+        {
+            if((s[i] & pins[line]) != (*last & pins[line]))
+                edges_count(NULL, pins[line], BOOL(s[i] & pins[line]), i);
+        }
+
+        *last = s[i];
+    }
+}
+
+void bench_edges()
+{
+    edges_t     edges;
+    uint16_t    last = 0;
+    uint64_t    start, block_ns, sample_ns;
+    int_t       run;
+    uint_t      i;
+
+    for(i = 0; i < EDGES_SAMPLES; ++i)
+    {
+        samples[i] = 0;
+
+        if(i >= 100 && i < 340)
+            samples[i] |= PIN_LX;
+        if(i >= 102 && i < 700)
+            samples[i] |= PIN_RX;
+    }
+
+    edges_init(&edges, PIN_LX | PIN_RX, edges_count, NULL);
+
+    edges_found = 0;
+    start = bench_now_ns();
+    for(run = 0; run < EDGES_RUNS; ++run)
+        edges_detect(&edges, samples, EDGES_SAMPLES);
+    block_ns = bench_now_ns() - start;
+
+    edges_found = 0;
+    start = bench_now_ns();
+    for(run = 0; run < EDGES_RUNS; ++run)
+        edges_per_sample(samples, EDGES_SAMPLES, &last);
+    sample_ns = bench_now_ns() - start;
+
+    printf("Edge detection: %d samples per buffer, 2 lines, 4 edges\n", EDGES_SAMPLES);
+    printf("%20s %12s\n", "", "ns/sample");
+    printf("%20s %12.3f\n", "per sample", STATIC_CAST(double, sample_ns) / EDGES_RUNS / EDGES_SAMPLES);
+    printf("%20s %12.3f\n", "block", STATIC_CAST(double, block_ns) / EDGES_RUNS / EDGES_SAMPLES);
+    printf("\n");
+}
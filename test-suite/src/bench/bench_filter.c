@@ -0,0 +1,73 @@
+#include <stdio.h>
+
+#include "types.h"
+
+#include "sensor.h"
+#include "filter.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Bearing Filters Benchmark
+ * --------------------------------------------------------------------------------
+ *
+ * Prints the memory kept by each filter for all the bearings and the time it
+ * takes for each distance, alone and in the robust chain, on sweeps of noisy
+ * distances over all the motor positions.
+ */
+
+#define FILTER_DISTANCES    (1024)
+#define FILTER_RUNS         (5000)
+
+static distance_t distances[FILTER_DISTANCES];
+static volatile distance_t sink;
+
+// Returns the nanoseconds taken by each distance with the given chain
+static double filter_time(const filter_kind_t kinds[], int_t count)
+{
+    uint64_t    start;
+    int_t       run;
+    int_t       i;
+
+    filter_set_chain(kinds, count);
+
+    start = bench_now_ns();
+    for(run = 0; run < FILTER_RUNS; ++run)
+    {
+        for(i = 0; i < FILTER_DISTANCES; ++i)
+            sink = filter_update(i % FILTER_BEARINGS, distances[i]);
+    }
+
+    return STATIC_CAST(double, bench_now_ns() - start) / FILTER_RUNS / FILTER_DISTANCES;
+}
+
+void bench_filter()
+{
+    static const char* names[FILTER_KINDS] =
+    {
+        [FILTER_MEDIAN] = "median",
+        [FILTER_EMA] = "ema",
+        [FILTER_GATE] = "gate",
+    };
+    const filter_kind_t robust[] = { FILTER_MEDIAN, FILTER_GATE, FILTER_EMA };
+    filter_kind_t       kind;
+    int_t               i;
+
+    // Steady objects, with a spurious distance every 7
+    for(i = 0; i < FILTER_DISTANCES; ++i)
+        distances[i] = i % 7 == 0 ? SENSOR_DIST_MAX : 100 + (i % FILTER_BEARINGS) + (i * 13) % 5;
+
+    printf("Bearing filters: %d bearings\n", FILTER_BEARINGS);
+    printf("%20s %12s %12s\n", "", "bytes", "ns/distance");
+    printf("%20s %12s %12.3f\n", "none", "0", filter_time(NULL, 0));
+
+    for(kind = 0; kind < FILTER_KINDS; ++kind)
+        printf("%20s %12u %12.3f\n", names[kind], filter_memory(kind), filter_time(&kind, 1));
+
+    printf("%20s %12u %12.3f\n", "median+gate+ema",
+            filter_memory(FILTER_MEDIAN) + filter_memory(FILTER_GATE) + filter_memory(FILTER_EMA),
+            filter_time(robust, 3));
+    printf("\n");
+
+    filter_init();
+}
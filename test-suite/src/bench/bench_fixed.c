@@ -0,0 +1,94 @@
+#include <stdio.h>
+
+#include "types.h"
+
+#include "fixed.h"
+#include "motor.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Fixed Point Benchmark
+ * --------------------------------------------------------------------------------
+ *
+ * Compares the distance filter of update_distance and the motor position
+ * conversions of motor.c in fixed point with their former double versions.
+ * The host has a double precision unit, the Cortex-M4F runs them in software.
+ */
+
+#define FIXED_VALUES    (1024)
+#define FIXED_RUNS      (20000)
+
+#define MARGIN          (0.8)
+#define SLOPE           (STATIC_CAST(double, USR_RANGE) / MOTOR_RANGE)
+
+static int_t values[FIXED_VALUES];
+static volatile int_t sink;
+
+// Former update_distance
+static int_t filter_double(int_t last, int_t distance)
+{
+    return MARGIN * distance + (1 - MARGIN) * last;
+}
+
+static int_t filter_fixed(int_t last, int_t distance)
+{
+    return Q15_BLEND(last, distance, Q15(MARGIN));
+}
+
+// Former motor_get_pos and motor_get_motor_pos
+static int_t motor_double(int_t pos)
+{
+    int_t usr = USR_MIN_POS + SLOPE * (pos - MOTOR_MIN);
+
+    return MOTOR_MIN + 1.0 / SLOPE * (usr - USR_MIN_POS);
+}
+
+static int_t motor_fixed(int_t pos)
+{
+    return USR_TO_MOTOR_POS(MOTOR_TO_USR_POS(pos));
+}
+
+// Returns the nanoseconds taken by each call of the given function
+static double fixed_time(int_t (*function)(int_t, int_t))
+{
+    uint64_t    start;
+    int_t       last = 0;
+    int_t       run;
+    int_t       i;
+
+    start = bench_now_ns();
+    for(run = 0; run < FIXED_RUNS; ++run)
+    {
+        for(i = 0; i < FIXED_VALUES; ++i)
+            last = function(last, values[i]);
+    }
+    sink = last;
+
+    return STATIC_CAST(double, bench_now_ns() - start) / FIXED_RUNS / FIXED_VALUES;
+}
+
+static int_t filter_double_call(int_t last, int_t value) { return filter_double(last, value); }
+static int_t filter_fixed_call(int_t last, int_t value) { return filter_fixed(last, value); }
+static int_t motor_double_call(int_t last, int_t value) { return last + motor_double(value); }
+static int_t motor_fixed_call(int_t last, int_t value) { return last + motor_fixed(value); }
+
+void bench_fixed()
+{
+    int_t   i;
+
+    for(i = 0; i < FIXED_VALUES; ++i)
+        values[i] = (i * 37) % 800;
+
+    printf("Fixed point: %d values\n", FIXED_VALUES);
+    printf("%20s %12s %12s\n", "", "double ns", "fixed ns");
+    printf("%20s %12.3f %12.3f\n", "distance filter",
+            fixed_time(filter_double_call), fixed_time(filter_fixed_call));
+
+    for(i = 0; i < FIXED_VALUES; ++i)
+        values[i] = MOTOR_MIN + (i % (USR_RANGE + 1)) * MOTOR_STP;
+
+    printf("%20s %12.3f %12.3f\n", "motor positions",
+            fixed_time(motor_double_call), fixed_time(motor_fixed_call));
+    printf("\n");
+}
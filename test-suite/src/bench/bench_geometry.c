@@ -0,0 +1,66 @@
+#include <stdio.h>
+
+#include "types.h"
+
+#include "sensor.h"
+#include "geometry.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Geometric Triangolation Benchmark
+ * --------------------------------------------------------------------------------
+ *
+ * Compares the time taken by the geometric triangolation of the left and the
+ * right distances, conversion to mm included, with the one of the nearest
+ * object fusion of triangolation, on a sweep of distances and positions.
+ */
+
+#define GEO_PAIRS       (1024)
+#define GEO_RUNS        (2000)
+
+// Private functions of sensor.c
+extern distance_t triangolation(const distance_t distances[], int_t count);
+
+static distance_t pairs[GEO_PAIRS][SENSORS_NUM];
+static volatile long_int_t sink;
+
+void bench_geometry()
+{
+    geo_point_t point;
+    uint64_t    start, fusion_ns, geo_ns;
+    int_t       run;
+    int_t       i;
+
+    for(i = 0; i < GEO_PAIRS; ++i)
+    {
+        pairs[i][SENSOR_LX] = CM_TO_DISTANCE(20 + i % 400);
+        pairs[i][SENSOR_RX] = pairs[i][SENSOR_LX] + i % 5 - 2;
+    }
+
+    start = bench_now_ns();
+    for(run = 0; run < GEO_RUNS; ++run)
+    {
+        for(i = 0; i < GEO_PAIRS; ++i)
+            sink = triangolation(pairs[i], SENSORS_NUM);
+    }
+    fusion_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for(run = 0; run < GEO_RUNS; ++run)
+    {
+        for(i = 0; i < GEO_PAIRS; ++i)
+        {
+            geo_locate(DISTANCE_TO_MM(pairs[i][SENSOR_LX]), DISTANCE_TO_MM(pairs[i][SENSOR_RX]),
+                    i % (USR_MAX_POS + 1), &point);
+            sink = point.x;
+        }
+    }
+    geo_ns = bench_now_ns() - start;
+
+    printf("Triangolation: %d pairs of distances\n", GEO_PAIRS);
+    printf("%20s %12s\n", "", "ns/pair");
+    printf("%20s %12.3f\n", "nearest fusion", STATIC_CAST(double, fusion_ns) / GEO_RUNS / GEO_PAIRS);
+    printf("%20s %12.3f\n", "geometric", STATIC_CAST(double, geo_ns) / GEO_RUNS / GEO_PAIRS);
+    printf("\n");
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+
+#include "types.h"
+
+#include "sensor.h"
+#include "grid.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Occupancy Grid Benchmark
+ * --------------------------------------------------------------------------------
+ *
+ * Prints the memory of the grid and the time taken by the update of a single
+ * distance, on sweeps over all the motor positions of near objects, far ones
+ * and nothing in sight, which frees the whole beam axis.
+ */
+
+#define GRID_PINGS      (1024)
+#define GRID_RUNS       (2000)
+
+static distance_t distances[GRID_PINGS];
+static volatile uint_t sink;
+
+// Returns the nanoseconds taken by each distance between the given ones, in cm
+static double grid_time(int_t min_cm, int_t max_cm)
+{
+    uint64_t    start;
+    int_t       run;
+    int_t       i;
+
+    for(i = 0; i < GRID_PINGS; ++i)
+        distances[i] = max_cm < 0 ? SENSOR_DIST_MAX :
+                CM_TO_DISTANCE(min_cm + (i * 37) % (max_cm - min_cm + 1));
+
+    grid_clear();
+
+    start = bench_now_ns();
+    for(run = 0; run < GRID_RUNS; ++run)
+    {
+        for(i = 0; i < GRID_PINGS; ++i)
+            sink = grid_update(i % GRID_BEARINGS, distances[i]);
+    }
+
+    return STATIC_CAST(double, bench_now_ns() - start) / GRID_RUNS / GRID_PINGS;
+}
+
+void bench_grid()
+{
+    grid_init();
+
+    printf("Occupancy grid: %dx%d cells of %d mm, %u bytes with the stencils\n",
+            GRID_WIDTH, GRID_HEIGHT, GRID_CELL_MM, grid_memory());
+    printf("%20s %12s\n", "", "ns/ping");
+    printf("%20s %12.3f\n", "20-100 cm", grid_time(20, 100));
+    printf("%20s %12.3f\n", "100-400 cm", grid_time(100, 400));
+    printf("%20s %12.3f\n", "nothing in sight", grid_time(0, -1));
+    printf("%20s %12d\n", "most cells written", GRID_WRITES_MAX);
+    printf("\n");
+
+    grid_clear();
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+
+#include "types.h"
+
+#include "sensor.h"
+#include "nearest.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Nearest Object Benchmark
+ * --------------------------------------------------------------------------------
+ *
+ * Prints the time taken by the update of a single distance and by the search
+ * of the nearest object in a sector, compared with a scan of the distances of
+ * the sector, on sectors of all the widths.
+ */
+
+#define NEAREST_PINGS   (1024)
+#define NEAREST_RUNS    (2000)
+
+static distance_t distances[NEAREST_PINGS];
+static distance_t scanned[NEAREST_BEARINGS];
+static volatile int_t sink;
+
+// Returns the position of the nearest distance between two positions, from 0,
+// scanning all of them
+static int_t nearest_scan(int_t first, int_t last)
+{
+    int_t best = first;
+    int_t i;
+
+    for(i = first + 1; i <= last; ++i)
+    {
+        if(scanned[i] < scanned[best])
+            best = i;
+    }
+
+    return best;
+}
+
+// Returns the nanoseconds taken by each update
+static double nearest_update_time()
+{
+    uint64_t    start;
+    int_t       run;
+    int_t       i;
+
+    start = bench_now_ns();
+    for(run = 0; run < NEAREST_RUNS; ++run)
+    {
+        for(i = 0; i < NEAREST_PINGS; ++i)
+            nearest_update(USR_MIN_POS + i % NEAREST_BEARINGS, distances[i]);
+    }
+
+    return STATIC_CAST(double, bench_now_ns() - start) / NEAREST_RUNS / NEAREST_PINGS;
+}
+
+// Returns the nanoseconds taken by each search in a sector of the given width,
+// with the tree or with a scan
+static double nearest_sector_time(int_t width, bool_t scan)
+{
+    distance_t  distance;
+    uint64_t    start;
+    int_t       first;
+    int_t       pos;
+    int_t       run;
+    int_t       i;
+
+    start = bench_now_ns();
+    for(run = 0; run < NEAREST_RUNS; ++run)
+    {
+        for(i = 0; i < NEAREST_PINGS; ++i)
+        {
+            first = (i * 7) % (NEAREST_BEARINGS - width + 1);
+
+            if(scan)
+                sink = nearest_scan(first, first + width - 1);
+            else
+            {
+                nearest_get_sector(USR_MIN_POS + first, USR_MIN_POS + first + width - 1,
+                        &pos, &distance);
+                sink = pos;
+            }
+        }
+    }
+
+    return STATIC_CAST(double, bench_now_ns() - start) / NEAREST_RUNS / NEAREST_PINGS;
+}
+
+void bench_nearest()
+{
+    int_t width;
+    int_t i;
+
+    for(i = 0; i < NEAREST_PINGS; ++i)
+        distances[i] = STATIC_CAST(distance_t, 20 + (i * 37) % 400);
+
+    nearest_init();
+
+    // Distances of all the positions, for the searches
+    for(i = 0; i < NEAREST_BEARINGS; ++i)
+    {
+        scanned[i] = distances[i];
+        nearest_update(USR_MIN_POS + i, distances[i]);
+    }
+
+    printf("Nearest object: %d bearings\n", NEAREST_BEARINGS);
+    printf("%20s %12.3f\n", "update ns", nearest_update_time());
+    printf("%20s %12s %12s\n", "sector width", "tree ns", "scan ns");
+
+    for(width = 1; width < NEAREST_BEARINGS; width *= 4)
+        printf("%20d %12.3f %12.3f\n", width,
+                nearest_sector_time(width, false), nearest_sector_time(width, true));
+
+    printf("%20d %12.3f %12.3f\n", NEAREST_BEARINGS,
+            nearest_sector_time(NEAREST_BEARINGS, false),
+            nearest_sector_time(NEAREST_BEARINGS, true));
+    printf("\n");
+
+    nearest_init();
+}
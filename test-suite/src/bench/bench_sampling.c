@@ -0,0 +1,73 @@
+#include <stdio.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "sim.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Gated Sampling Simulation
+ * --------------------------------------------------------------------------------
+ *
+ * Counts the calls of sensors_read that actually sample the echo pins during a
+ * step, for objects at different distances, with and without gating.
+ */
+
+#define SAMPLING_STEPS  (10)    // Steps simulated for each distance
+#define ECHO_DELAY      (10)    // Ticks from the trigger to the echo start
+
+// Converts a distance in cm to the width of its echo in ticks
+#define CM_TO_TICKS(cm) (STATIC_CAST(long_int_t, cm) * 2 * 10000 / 340 / SYST_PERIOD)
+
+// Returns the average number of samples per step with the given echo width
+static uint_t sampling_run(int_t mode, int_t width)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, width }, { ECHO_DELAY, width } };
+    uint_t  samples = 0;
+    int_t   i;
+
+    sensors_set_sampling(mode);
+
+    // The first step is discarded, since the mode changed during it
+    sim_polling_step(echoes);
+
+    for(i = 0; i < SAMPLING_STEPS; ++i)
+    {
+        sim_polling_step(echoes);
+        samples += sensors_get_step_samples();
+    }
+
+    return samples / SAMPLING_STEPS;
+}
+
+void bench_sampling()
+{
+    static const int_t distances[] = { 20, 50, 100, 200, 400, 600, -1 };
+    uint_t  always, gated;
+    int_t   i, width;
+
+    printf("Gated sampling: samples per step (%d systicks per step)\n", STEP_PERIOD_TICKS);
+    printf("%10s %10s %10s %10s\n", "cm", "always", "gated", "saved %");
+
+    for(i = 0; i < sizeof(distances) / sizeof(distances[0]); ++i)
+    {
+        width = distances[i] < 0 ? -1 : CM_TO_TICKS(distances[i]);
+
+        always = sampling_run(SENSOR_SAMPLING_ALWAYS, width);
+        gated = sampling_run(SENSOR_SAMPLING_GATED, width);
+
+        if(distances[i] < 0)
+            printf("%10s", "no echo");
+        else
+            printf("%10d", distances[i]);
+
+        printf(" %10u %10u %10u\n", always, gated, 100 - 100 * gated / always);
+    }
+
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+
+    printf("\n");
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "sim.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Adaptive Step Simulation
+ * --------------------------------------------------------------------------------
+ *
+ * Compares the number of steps per second of the fixed step period against the
+ * adaptive one, in simulated time, for objects at different distances.
+ */
+
+#define STEP_STEPS      (10)    // Steps simulated for each distance
+#define ECHO_DELAY      (10)    // Ticks from the trigger to the echo start
+#define STEP_FAR_CM     (650)   // Distance of an object beyond all ranges
+
+// Converts a distance in cm to the width of its echo in ticks
+#define CM_TO_TICKS(cm) (STATIC_CAST(long_int_t, cm) * 2 * 10000 / 340 / SYST_PERIOD)
+
+// Returns the average step duration in ticks with the given echo width
+static uint_t step_run(bool_t adaptive, int_t width)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, width }, { ECHO_DELAY, width } };
+    uint_t  ticks = 0;
+    int_t   i;
+
+    // The first steps settle the sensors after the previous distance
+    sim_polling_step(echoes);
+    sim_polling_step(echoes);
+
+    for(i = 0; i < STEP_STEPS; ++i)
+        ticks += adaptive ? sim_adaptive_step(echoes) : sim_polling_step(echoes);
+
+    return ticks / STEP_STEPS;
+}
+
+// Prints the samples and steps per second of the adaptive step with gated
+// sampling when the range follows the zoom levels of the gui, with an object
+// beyond all of them
+static void bench_step_range()
+{
+    static const int_t ranges[] = { 600, 400, 200, 100, 50, 20 };
+    uint_t  adaptive;
+    int_t   i;
+
+    printf("Adaptive step with range window: gated samples and steps per second, object at %d cm\n", STEP_FAR_CM);
+    printf("%10s %10s %10s\n", "range cm", "samples", "adaptive");
+
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+
+    for(i = 0; i < sizeof(ranges) / sizeof(ranges[0]); ++i)
+    {
+        sensors_set_range(CM_TO_DISTANCE(ranges[i]));
+        adaptive = step_run(true, CM_TO_TICKS(STEP_FAR_CM));
+
+        printf("%10d %10u %10.1f\n", ranges[i], sensors_get_step_samples(),
+                1000000.0 / (adaptive * SYST_PERIOD));
+    }
+
+    sensors_set_range(SENSOR_DIST_MAX);
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+
+    printf("\n");
+}
+
+void bench_step()
+{
+    static const int_t distances[] = { 10, 30, 50, 100, 200, 400, 600, -1 };
+    uint_t  fixed, adaptive;
+    int_t   i, width;
+
+    printf("Adaptive step: steps per second (guard %d us, min %d us)\n", STEP_GUARD, STEP_MIN);
+    printf("%10s %10s %10s %10s\n", "cm", "fixed", "adaptive", "speedup");
+
+    for(i = 0; i < sizeof(distances) / sizeof(distances[0]); ++i)
+    {
+        width = distances[i] < 0 ? -1 : CM_TO_TICKS(distances[i]);
+
+        fixed = step_run(false, width);
+        adaptive = step_run(true, width);
+
+        if(distances[i] < 0)
+            printf("%10s", "no echo");
+        else
+            printf("%10d", distances[i]);
+
+        printf(" %10.1f %10.1f %9.1fx\n",
+                1000000.0 / (fixed * SYST_PERIOD),
+                1000000.0 / (adaptive * SYST_PERIOD),
+                STATIC_CAST(double, fixed) / adaptive);
+    }
+
+    printf("\n");
+
+    bench_step_range();
+}
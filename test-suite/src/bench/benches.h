@@ -0,0 +1,27 @@
+#ifndef BENCHES_H
+#define BENCHES_H
+
+#include <stdint.h>
+
+/*
+ * Returns the time of a monotonic clock, in nanoseconds.
+ */
+extern uint64_t bench_now_ns();
+
+/* --------------------------------------------------------------------------------
+ * Each benchmark file runs its own measurements through one of these
+ * functions, called by main.c, and prints the results on the standard output.
+ * --------------------------------------------------------------------------------
+ */
+
+extern void bench_sampling();
+extern void bench_edges();
+extern void bench_step();
+extern void bench_geometry();
+extern void bench_fixed();
+extern void bench_filter();
+extern void bench_grid();
+extern void bench_nearest();
+extern void bench_alarm();
+
+#endif
@@ -0,0 +1,43 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "hal.h"
+#include "sensor.h"
+
+#include "benches.h"
+
+/* --------------------------------------------------------------------------------
+ *                                    Main
+ * --------------------------------------------------------------------------------
+ *
+ * Runs the host benchmarks and simulations of the firmware modules, compiled
+ * against the stub in src/stub.
+ */
+
+uint64_t bench_now_ns()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return STATIC_CAST(uint64_t, now.tv_sec) * 1000000000u + now.tv_nsec;
+}
+
+int main(int argc, char* argv[])
+{
+    hal_stub_reset();
+    sensors_init();
+
+    bench_sampling();
+    bench_edges();
+    bench_step();
+    bench_geometry();
+    bench_fixed();
+    bench_filter();
+    bench_grid();
+    bench_nearest();
+    bench_alarm();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <CUnit/CUnit.h>
+#include <CUnit/Automated.h>
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                                    Main
+ * --------------------------------------------------------------------------------
+ *
+ * Runs the tests of the firmware modules, compiled for the host against the
+ * stub in src/stub.
+ */
+
+int main(int argc, char* argv[])
+{
+    if(CUE_SUCCESS != CU_initialize_registry())
+    {
+        printf("Could not initialize CUnit registry!\r\n");
+
+        return CU_get_error();
+    }
+
+    CU_set_error_action(CUEA_FAIL);
+
+    fsm_add_suites();
+    capture_add_suites();
+    sampling_add_suites();
+    edges_add_suites();
+    fusion_add_suites();
+    step_add_suites();
+    range_add_suites();
+    trigger_add_suites();
+    queue_add_suites();
+    returns_add_suites();
+    health_add_suites();
+    dither_add_suites();
+    calib_add_suites();
+    sound_add_suites();
+    geo_add_suites();
+    fixed_add_suites();
+    filter_add_suites();
+    tracker_add_suites();
+    grid_add_suites();
+    segment_add_suites();
+    change_add_suites();
+    background_add_suites();
+    nearest_add_suites();
+    alarm_add_suites();
+
+    // Running all the tests
+    CU_set_output_filename("res-unit/Sonar-Firmware-Test");
+    CU_automated_run_tests();
+    CU_list_tests_to_file();
+
+    CU_cleanup_registry();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+#ifndef SUITES_H
+#define SUITES_H
+
+/* --------------------------------------------------------------------------------
+ * Each test file adds its own suites to the CUnit registry through one of
+ * these functions, called by main.c.
+ * --------------------------------------------------------------------------------
+ */
+
+extern void fsm_add_suites();
+extern void capture_add_suites();
+extern void sampling_add_suites();
+extern void edges_add_suites();
+extern void fusion_add_suites();
+extern void step_add_suites();
+extern void range_add_suites();
+extern void trigger_add_suites();
+extern void queue_add_suites();
+extern void returns_add_suites();
+extern void health_add_suites();
+extern void dither_add_suites();
+extern void calib_add_suites();
+extern void sound_add_suites();
+extern void geo_add_suites();
+extern void fixed_add_suites();
+extern void filter_add_suites();
+extern void tracker_add_suites();
+extern void grid_add_suites();
+extern void segment_add_suites();
+extern void change_add_suites();
+extern void background_add_suites();
+extern void nearest_add_suites();
+extern void alarm_add_suites();
+
+#endif
@@ -0,0 +1,144 @@
+#include <CUnit/CUnit.h>
+
+#include "hal.h"
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "alarm.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Proximity Alarm Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define THRESHOLD   (40)            // Samples of the echo of the threshold
+#define ECHO_DELAY  (10)
+#define NEAR        (THRESHOLD / 2)
+#define FAR         (THRESHOLD * 3)
+
+// Threshold in number of ticks
+#define THRESHOLD_TICKS (THRESHOLD * SYST_PERIOD / DISTANCE_PERIOD)
+
+// Tells whether the alarm output is raised
+#define OUTPUT()    TM_GPIO_GetOutputPinValue(ALARM_PORT, ALARM_PIN)
+
+int alarm_suite_init()
+{
+    alarm_init();
+
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    return 0;
+}
+
+int alarm_suite_clean()
+{
+    alarm_init();
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void alarm_threshold()
+{
+    alarm_init();
+
+    CU_ASSERT_EQUAL(alarm_get_threshold(), CM_TO_DISTANCE(ALARM_CM_DEFAULT));
+    CU_ASSERT_FALSE(alarm_is_on());
+    CU_ASSERT_FALSE(OUTPUT());
+
+    alarm_set_threshold(-1);
+    CU_ASSERT_EQUAL(alarm_get_threshold(), 0);
+
+    alarm_set_threshold(SENSOR_DIST_MAX + 1);
+    CU_ASSERT_EQUAL(alarm_get_threshold(), SENSOR_DIST_MAX);
+
+    // Disabled, even the nearest echo is ignored
+    alarm_set_threshold(0);
+    alarm_update(SENSOR_LX, 0, true);
+    CU_ASSERT_FALSE(alarm_is_on());
+}
+
+void alarm_sensors()
+{
+    alarm_init();
+    alarm_set_threshold(THRESHOLD_TICKS);
+
+    // A running echo is not known to be short yet
+    alarm_update(SENSOR_LX, THRESHOLD_TICKS / 2, false);
+    CU_ASSERT_FALSE(OUTPUT());
+
+    alarm_update(SENSOR_LX, THRESHOLD_TICKS, true);
+    CU_ASSERT_TRUE(alarm_is_on());
+    CU_ASSERT_TRUE(OUTPUT());
+
+    // Raised as long as one sensor sees the object
+    alarm_update(SENSOR_RX, THRESHOLD_TICKS / 2, true);
+    alarm_update(SENSOR_LX, THRESHOLD_TICKS + 1, true);
+    CU_ASSERT_TRUE(OUTPUT());
+
+    alarm_clear(SENSOR_RX);
+    CU_ASSERT_FALSE(alarm_is_on());
+    CU_ASSERT_FALSE(OUTPUT());
+
+    // Lowered by a running echo beyond the threshold
+    alarm_update(SENSOR_RX, 1, true);
+    alarm_update(SENSOR_RX, THRESHOLD_TICKS + 1, false);
+    CU_ASSERT_FALSE(OUTPUT());
+
+    // And by disabling it
+    alarm_update(SENSOR_RX, 1, true);
+    alarm_set_threshold(0);
+    CU_ASSERT_FALSE(OUTPUT());
+
+    alarm_set_threshold(THRESHOLD_TICKS);
+    alarm_update(SENSORS_NUM, 1, true);
+    alarm_update(-1, 1, true);
+    CU_ASSERT_FALSE(alarm_is_on());
+}
+
+void alarm_latency()
+{
+    const sim_echo_t near[SENSORS_NUM] = { { ECHO_DELAY, NEAR }, { ECHO_DELAY, FAR } };
+    const sim_echo_t far[SENSORS_NUM] = { { ECHO_DELAY, FAR }, { ECHO_DELAY, FAR } };
+    const sim_echo_t none[SENSORS_NUM] = { { ECHO_DELAY, -1 }, { ECHO_DELAY, -1 } };
+
+    alarm_init();
+    alarm_set_threshold(THRESHOLD_TICKS);
+
+    sim_polling_step(far);
+    CU_ASSERT_FALSE(alarm_is_on());
+
+    // Raised at the first sample of the end of the echo, long before the
+    // distance of the step
+    CU_ASSERT_EQUAL(sim_alarm_step(near), ECHO_DELAY + NEAR);
+    CU_ASSERT_TRUE(alarm_is_on());
+
+    // Lowered by an echo beyond the threshold and by no echo at all
+    sim_polling_step(far);
+    CU_ASSERT_FALSE(alarm_is_on());
+
+    CU_ASSERT_EQUAL(sim_alarm_step(near), ECHO_DELAY + NEAR);
+    sim_polling_step(none);
+    CU_ASSERT_FALSE(alarm_is_on());
+
+    // Disabled, the step is measured as usual
+    alarm_set_threshold(0);
+    CU_ASSERT_EQUAL(sim_alarm_step(near), -1);
+    sim_polling_step(far);
+}
+
+void alarm_add_suites()
+{
+    CU_pSuite alarm = CU_add_suite("Proximity Alarm Testing", alarm_suite_init, alarm_suite_clean);
+
+    CU_add_test(alarm, "Threshold Testing", alarm_threshold);
+    CU_add_test(alarm, "Sensors Testing", alarm_sensors);
+    CU_add_test(alarm, "Latency Testing", alarm_latency);
+}
@@ -0,0 +1,142 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "background.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Background Model Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define WALL        (20000 / DISTANCE_PERIOD)   // About 3.4 m away
+#define NOISE       (BACKGROUND_BAND_MIN)
+#define INTRUDER    (WALL / 2)
+
+// Recorded distances of a wall, jittering around it
+static const distance_t recorded[] =
+{
+    WALL, WALL + NOISE, WALL - NOISE, WALL, WALL + NOISE / 2, WALL - NOISE / 2,
+    WALL + NOISE, WALL, WALL - NOISE, WALL,
+};
+
+#define RECORDED    STATIC_CAST(int_t, sizeof(recorded) / sizeof(recorded[0]))
+
+// Feeds the recorded wall to a position, returning the distances in the
+// foreground
+int_t background_feed(int_t pos, int_t visits)
+{
+    int_t foreground = 0;
+    int_t i;
+
+    for(i = 0; i < visits; ++i)
+        foreground += background_update(pos, recorded[i % RECORDED]);
+
+    return foreground;
+}
+
+int background_suite_init()
+{
+    background_init();
+
+    return 0;
+}
+
+int background_suite_clean()
+{
+    background_init();
+
+    return 0;
+}
+
+void background_learning()
+{
+    distance_t  distance;
+    distance_t  band;
+
+    background_init();
+
+    // All shown until known
+    CU_ASSERT_FALSE(background_get(USR_MID_POS, &distance, &band));
+    CU_ASSERT_EQUAL(background_feed(USR_MID_POS, BACKGROUND_LEARN), BACKGROUND_LEARN);
+    CU_ASSERT_TRUE_FATAL(background_get(USR_MID_POS, &distance, &band));
+
+    CU_ASSERT(distance >= WALL - 1 && distance <= WALL + 1);
+    CU_ASSERT(band > BACKGROUND_BAND_MIN + NOISE && band < BACKGROUND_BAND_MIN + 4 * NOISE);
+
+    // Then the wall matches it
+    CU_ASSERT_EQUAL(background_feed(USR_MID_POS, 10 * RECORDED), 0);
+    CU_ASSERT_FALSE(background_get(USR_MID_POS + 1, &distance, &band));
+    CU_ASSERT_FALSE(background_get(USR_MAX_POS + 1, &distance, &band));
+    CU_ASSERT_TRUE(background_update(USR_MAX_POS + 1, WALL));
+}
+
+void background_intruder()
+{
+    distance_t  distance;
+    distance_t  band;
+    int_t       i;
+
+    background_init();
+    background_feed(USR_MID_POS, BACKGROUND_LEARN + RECORDED);
+
+    // Passing in front of the wall, without moving it
+    for(i = 0; i < BACKGROUND_ABSORB - 1; ++i)
+        CU_ASSERT_TRUE(background_update(USR_MID_POS, INTRUDER));
+
+    CU_ASSERT_FALSE(background_update(USR_MID_POS, WALL));
+    CU_ASSERT_TRUE(background_get(USR_MID_POS, &distance, &band));
+    CU_ASSERT(distance >= WALL - 1 && distance <= WALL + 1);
+
+    // Staying there, until it is the background
+    for(i = 0; i < BACKGROUND_ABSORB; ++i)
+        CU_ASSERT_TRUE(background_update(USR_MID_POS, INTRUDER));
+
+    CU_ASSERT_FALSE(background_update(USR_MID_POS, INTRUDER));
+    CU_ASSERT_TRUE(background_update(USR_MID_POS, WALL));
+
+    // Nothing in sight is a background too
+    background_init();
+
+    for(i = 0; i < BACKGROUND_LEARN; ++i)
+        background_update(USR_MIN_POS, SENSOR_DIST_MAX);
+
+    CU_ASSERT_FALSE(background_update(USR_MIN_POS, SENSOR_DIST_MAX));
+    CU_ASSERT_TRUE(background_update(USR_MIN_POS, SENSOR_DIST_MAX - 2 * BACKGROUND_BAND_MIN));
+}
+
+void background_suppression()
+{
+    background_init();
+    background_feed(USR_MID_POS, BACKGROUND_LEARN + 1);
+
+    CU_ASSERT_EQUAL(background_hides(USR_MID_POS), BACKGROUND_SUPPRESS_DEFAULT);
+
+    // Only the distances matching the background are hidden
+    background_set_suppress(true);
+    CU_ASSERT_TRUE(background_hides(USR_MID_POS));
+    CU_ASSERT_FALSE(background_hides(USR_MID_POS + 1));
+    CU_ASSERT_FALSE(background_hides(USR_MAX_POS + 1));
+
+    background_update(USR_MID_POS, INTRUDER);
+    CU_ASSERT_FALSE(background_hides(USR_MID_POS));
+
+    background_update(USR_MID_POS, WALL);
+    CU_ASSERT_TRUE(background_hides(USR_MID_POS));
+
+    background_set_suppress(false);
+    CU_ASSERT_FALSE(background_hides(USR_MID_POS));
+}
+
+void background_add_suites()
+{
+    CU_pSuite background = CU_add_suite("Background Model Testing", background_suite_init, background_suite_clean);
+
+    CU_add_test(background, "Learning Testing", background_learning);
+    CU_add_test(background, "Intruder Testing", background_intruder);
+    CU_add_test(background, "Suppression Testing", background_suppression);
+}
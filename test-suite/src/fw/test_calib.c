@@ -0,0 +1,199 @@
+#include <CUnit/CUnit.h>
+
+#include "hal.h"
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sensor_config.h"
+#include "calib.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Sensors Calibration Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Bias of the simulated left sensor: its echoes last LATENCY microseconds
+// more than their flight, which in turn is measured GAIN_NUM / GAIN_DEN long
+#define LATENCY     (300)
+#define GAIN_NUM    (100)
+#define GAIN_DEN    (103)
+
+// Time elapsed between the trigger and the start of the echo
+#define ECHO_DELAY  (500)
+
+// Simulated time of the capture timer
+static stamp_t now;
+
+// Duration of the echo of an object at the given distance, as measured by a
+// biased sensor
+stamp_t calib_biased(int_t cm)
+{
+    return CALIB_CM_TO_US(cm) * GAIN_NUM / GAIN_DEN + LATENCY;
+}
+
+// Simulates a whole step in which both sensors see an object at the given
+// distance, the left one with the bias
+void calib_step(int_t cm)
+{
+    sensors_echo_edge(SENSOR_LX, true, now + ECHO_DELAY);
+    sensors_echo_edge(SENSOR_LX, false, now + ECHO_DELAY + calib_biased(cm));
+    sensors_echo_edge(SENSOR_RX, true, now + ECHO_DELAY);
+    sensors_echo_edge(SENSOR_RX, false, now + ECHO_DELAY + CALIB_CM_TO_US(cm));
+
+    now += STEP_PERIOD;
+    sensors_send_trigger();
+}
+
+// Returns the distance in cm measured by a sensor at the last step
+int_t calib_measured(int_t id)
+{
+    returns_t returns;
+
+    CU_ASSERT_TRUE(sensors_get_returns(id, &returns));
+
+    return DISTANCE_TO_CM(returns.echoes[0].width);
+}
+
+int calib_suite_init()
+{
+    hal_stub_reset();
+    sensors_init();
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    now = 0;
+    sensors_send_trigger();
+
+    // Settles both sensors in the OK state
+    calib_step(100);
+
+    return 0;
+}
+
+int calib_suite_clean()
+{
+    sensors_set_calibration(SENSOR_LX, &sensor_calib[SENSOR_LX]);
+    sensors_set_calibration(SENSOR_RX, &sensor_calib[SENSOR_RX]);
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void calib_fit_line()
+{
+    calib_t         calib;
+    sensor_calib_t  result;
+    int_t           cm;
+
+    calib_init(&calib);
+    CU_ASSERT_FALSE(calib_fit(&calib, &result));
+
+    for(cm = 10; cm <= 300; cm += 10)
+        calib_add(&calib, calib_biased(cm), CALIB_CM_TO_US(cm));
+
+    CU_ASSERT_TRUE_FATAL(calib_fit(&calib, &result));
+
+    CU_ASSERT(result.offset >= LATENCY - 2 && result.offset <= LATENCY + 2);
+    CU_ASSERT(result.gain >= SENSOR_CALIB_UNIT * GAIN_DEN / GAIN_NUM - 2);
+    CU_ASSERT(result.gain <= SENSOR_CALIB_UNIT * GAIN_DEN / GAIN_NUM + 2);
+}
+
+void calib_fit_offset()
+{
+    calib_t         calib;
+    sensor_calib_t  result;
+
+    // A single distance gives only the offset
+    calib_init(&calib);
+    calib_add(&calib, CALIB_CM_TO_US(50) + LATENCY - 1, CALIB_CM_TO_US(50));
+    calib_add(&calib, CALIB_CM_TO_US(50) + LATENCY + 1, CALIB_CM_TO_US(50));
+
+    CU_ASSERT_TRUE_FATAL(calib_fit(&calib, &result));
+    CU_ASSERT_EQUAL(result.offset, LATENCY);
+    CU_ASSERT_EQUAL(result.gain, SENSOR_CALIB_UNIT);
+
+    // Implausible gains are refused, too long measures ignored
+    calib_init(&calib);
+    calib_add(&calib, 1000, 3000);
+    calib_add(&calib, 2000, 6000);
+    calib_add(&calib, CALIB_US_MAX + 1, 1000);
+
+    CU_ASSERT_EQUAL(calib.count, 2);
+    CU_ASSERT_FALSE(calib_fit(&calib, &result));
+}
+
+void calib_sensors()
+{
+    calib_t         calib;
+    sensor_calib_t  result;
+    stamp_t         raw;
+    int_t           cm;
+
+    // Uncalibrated, near objects are seen farther by the biased sensor
+    calib_step(20);
+    CU_ASSERT(calib_measured(SENSOR_LX) >= 24);
+    CU_ASSERT(calib_measured(SENSOR_RX) >= 19 && calib_measured(SENSOR_RX) <= 20);
+
+    // Measures of known distances
+    calib_init(&calib);
+
+    for(cm = 20; cm <= 200; cm += 30)
+    {
+        calib_step(cm);
+
+        CU_ASSERT_TRUE(sensors_get_raw_width(SENSOR_LX, &raw));
+        calib_add(&calib, raw, CALIB_CM_TO_US(cm));
+    }
+
+    CU_ASSERT_TRUE_FATAL(calib_fit(&calib, &result));
+    sensors_set_calibration(SENSOR_LX, &result);
+
+    // Then each reading of the sensors is unbiased
+    for(cm = 10; cm <= 100; cm += 5)
+    {
+        calib_step(cm);
+
+        CU_ASSERT(calib_measured(SENSOR_LX) >= cm - 1 && calib_measured(SENSOR_LX) <= cm);
+        CU_ASSERT(calib_measured(SENSOR_RX) >= cm - 1 && calib_measured(SENSOR_RX) <= cm);
+    }
+
+    // The raw width stays the measured one
+    CU_ASSERT_TRUE(sensors_get_raw_width(SENSOR_LX, &raw));
+    CU_ASSERT_EQUAL(raw, calib_biased(100));
+    CU_ASSERT_FALSE(sensors_get_raw_width(SENSORS_NUM, &raw));
+}
+
+void calib_limits()
+{
+    const sensor_calib_t none = { 0, SENSOR_CALIB_UNIT };
+    const sensor_calib_t low = { 0, 1 };
+    const sensor_calib_t late = { 30000, SENSOR_CALIB_UNIT };
+    int_t                full;
+
+    sensors_set_calibration(SENSOR_LX, &none);
+    calib_step(100);
+    full = calib_measured(SENSOR_LX);
+
+    // Gains are limited, echoes shorter than the latency are at no distance
+    sensors_set_calibration(SENSOR_LX, &low);
+    calib_step(100);
+    CU_ASSERT(calib_measured(SENSOR_LX) >= full / 2 - 1 && calib_measured(SENSOR_LX) <= full / 2);
+
+    sensors_set_calibration(SENSOR_LX, &late);
+    calib_step(100);
+    CU_ASSERT_EQUAL(calib_measured(SENSOR_LX), 0);
+}
+
+void calib_add_suites()
+{
+    CU_pSuite calib = CU_add_suite("Sensors Calibration Testing", calib_suite_init, calib_suite_clean);
+
+    CU_add_test(calib, "Line Fit Testing", calib_fit_line);
+    CU_add_test(calib, "Offset Fit Testing", calib_fit_offset);
+    CU_add_test(calib, "Calibrated Sensors Testing", calib_sensors);
+    CU_add_test(calib, "Calibration Limits Testing", calib_limits);
+}
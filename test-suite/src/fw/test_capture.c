@@ -0,0 +1,182 @@
+#include <CUnit/CUnit.h>
+
+#include "hal.h"
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                      Edge Driven Acquisition Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t current_distance();
+
+// Time elapsed between the trigger and the start of the echo, it does not
+// affect the measured width
+#define ECHO_DELAY      (500)
+
+// Simulated time of the capture timer
+static stamp_t now;
+
+// Notifies the edges of an echo of the given width to a sensor, as the capture
+// timer would do
+void capture_echo(int_t id, stamp_t width)
+{
+    sensors_echo_edge(id, true, now + ECHO_DELAY);
+    sensors_echo_edge(id, false, now + ECHO_DELAY + width);
+}
+
+// Simulates a whole step with the given echo widths, then returns the
+// distance calculated at the next trigger
+distance_t capture_step(stamp_t width_lx, stamp_t width_rx)
+{
+    capture_echo(SENSOR_LX, width_lx);
+    capture_echo(SENSOR_RX, width_rx);
+
+    now += STEP_PERIOD;
+    sensors_send_trigger();
+
+    return current_distance();
+}
+
+// Simulates a whole step polling both echo lines every SYST_PERIOD, with both
+// echoes starting on the first sample, then returns the distance calculated at
+// the next trigger
+distance_t polling_step(int_t ticks_lx, int_t ticks_rx)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { 0, ticks_lx }, { 0, ticks_rx } };
+
+    sim_polling_step(echoes);
+
+    return current_distance();
+}
+
+int capture_suite_init()
+{
+    hal_stub_reset();
+    sensors_init();
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    now = 0;
+    sensors_send_trigger();
+
+    // Settles both sensors in the OK state
+    capture_step(1000, 1000);
+
+    return 0;
+}
+
+int capture_suite_clean()
+{
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void capture_exact_width()
+{
+    CU_ASSERT_EQUAL(capture_step(1000, 1000), 1000 / DISTANCE_PERIOD);
+    CU_ASSERT_EQUAL(capture_step(DISTANCE_PERIOD, DISTANCE_PERIOD), 1);
+}
+
+void capture_rounding()
+{
+    // Widths are rounded to the nearest tick
+    CU_ASSERT_EQUAL(capture_step(20 * DISTANCE_PERIOD + (DISTANCE_PERIOD - 1) / 2,
+            20 * DISTANCE_PERIOD + (DISTANCE_PERIOD - 1) / 2), 20);
+    CU_ASSERT_EQUAL(capture_step(20 * DISTANCE_PERIOD + (DISTANCE_PERIOD + 1) / 2,
+            20 * DISTANCE_PERIOD + (DISTANCE_PERIOD + 1) / 2), 21);
+    CU_ASSERT_EQUAL(capture_step((DISTANCE_PERIOD - 1) / 2, (DISTANCE_PERIOD - 1) / 2), 0);
+}
+
+void capture_overflow()
+{
+    // Echoes that start before the timer overflow and end after it
+    now = 0xFFFFFFFFu - ECHO_DELAY - 1000;
+
+    CU_ASSERT_EQUAL(capture_step(2000, 2000), 2000 / DISTANCE_PERIOD);
+    CU_ASSERT_EQUAL(capture_step(2000, 2000), 2000 / DISTANCE_PERIOD);
+}
+
+void capture_too_long()
+{
+    CU_ASSERT_EQUAL(capture_step(60000, 60000), SENSOR_DIST_MAX);
+    CU_ASSERT_EQUAL(capture_step(60000, 1000), 1000 / DISTANCE_PERIOD);
+}
+
+void capture_to_cm()
+{
+    // 1 m is 5882 us of round trip at 340 m/s
+    CU_ASSERT_EQUAL(DISTANCE_TO_CM(capture_step(5882, 5882)), 100);
+    CU_ASSERT_EQUAL(DISTANCE_TO_CM(capture_step(1176, 1176)), 20);
+}
+
+void capture_to_mm()
+{
+    distance_t distance;
+
+    // Millimeters are exact up to the resolution of a tick, plus the truncation
+    distance = capture_step(5882, 5882);
+    CU_ASSERT(DISTANCE_TO_MM(distance) >= 1000 - DISTANCE_TO_MM(1) - 1);
+    CU_ASSERT(DISTANCE_TO_MM(distance) <= 1000 + DISTANCE_TO_MM(1) + 1);
+
+    // 7 m is 41000 us at the default temperature, about 340.4 m/s
+    distance = capture_step(41000, 41000);
+    CU_ASSERT(DISTANCE_TO_MM(distance) >= 6977 - DISTANCE_TO_MM(1) - 1);
+    CU_ASSERT(DISTANCE_TO_MM(distance) <= 6977 + DISTANCE_TO_MM(1) + 1);
+}
+
+void capture_spurious_edges()
+{
+    distance_t distance;
+
+    // A second echo in the same window is not considered
+    capture_echo(SENSOR_LX, 3000);
+    capture_echo(SENSOR_RX, 3000);
+
+    sensors_echo_edge(SENSOR_LX, true, now + 10000);
+    sensors_echo_edge(SENSOR_LX, false, now + 10100);
+
+    now += STEP_PERIOD;
+    sensors_send_trigger();
+
+    distance = current_distance();
+
+    CU_ASSERT_EQUAL(distance, 3000 / DISTANCE_PERIOD);
+
+    // Invalid sensor identifiers are ignored
+    sensors_echo_edge(-1, true, now);
+    sensors_echo_edge(SENSORS_NUM, true, now);
+
+    CU_ASSERT_EQUAL(capture_step(1000, 1000), 1000 / DISTANCE_PERIOD);
+}
+
+void capture_polling_equivalence()
+{
+    // Polling and capture must agree on widths that are multiple of the tick
+    CU_ASSERT_EQUAL(polling_step(20, 20), capture_step(20 * SYST_PERIOD, 20 * SYST_PERIOD));
+    CU_ASSERT_EQUAL(polling_step(100, 100), SIM_DISTANCE(100));
+    CU_ASSERT_EQUAL(capture_step(100 * SYST_PERIOD, 100 * SYST_PERIOD), SIM_DISTANCE(100));
+}
+
+void capture_add_suites()
+{
+    CU_pSuite capture = CU_add_suite("Edge Driven Acquisition Functional Testing", capture_suite_init, capture_suite_clean);
+
+    CU_add_test(capture, "Exact Width Testing", capture_exact_width);
+    CU_add_test(capture, "Rounding Testing", capture_rounding);
+    CU_add_test(capture, "Timer Overflow Testing", capture_overflow);
+    CU_add_test(capture, "Too Long Echo Testing", capture_too_long);
+    CU_add_test(capture, "Centimeters Conversion Testing", capture_to_cm);
+    CU_add_test(capture, "Millimeters Conversion Testing", capture_to_mm);
+    CU_add_test(capture, "Spurious Edges Testing", capture_spurious_edges);
+    CU_add_test(capture, "Polling Equivalence Testing", capture_polling_equivalence);
+}
@@ -0,0 +1,162 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "filter.h"
+#include "change.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Change Detection Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define NEAR        (100)
+#define ECHO_DELAY  (10)
+
+// Measures the same distance at all the positions, as a sweep
+void change_sweep(distance_t distance)
+{
+    int_t pos;
+
+    for(pos = USR_MIN_POS; pos <= USR_MAX_POS; ++pos)
+        change_update(pos, distance);
+}
+
+int change_suite_init()
+{
+    change_init();
+
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    return 0;
+}
+
+int change_suite_clean()
+{
+    change_init();
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void change_threshold()
+{
+    change_init();
+
+    // The first visit has nothing to be compared with
+    CU_ASSERT_FALSE(change_update(USR_MID_POS, NEAR));
+    CU_ASSERT_FALSE(change_update(USR_MID_POS, NEAR + CHANGE_MIN - 1));
+    CU_ASSERT_EQUAL(change_count(), 0);
+
+    // Compared with the last visit only, so that slow changes are not flagged
+    CU_ASSERT_FALSE(change_update(USR_MID_POS, NEAR + 2 * CHANGE_MIN - 2));
+    CU_ASSERT_TRUE(change_update(USR_MID_POS, NEAR + CHANGE_MIN - 2));
+    CU_ASSERT_EQUAL(change_count(), 1);
+    CU_ASSERT_TRUE(change_update(USR_MID_POS, NEAR + 2 * CHANGE_MIN - 2));
+    CU_ASSERT_EQUAL(change_count(), 1);
+
+    // Cleared at the next visit if it stays still
+    CU_ASSERT_FALSE(change_update(USR_MID_POS, NEAR + 2 * CHANGE_MIN - 2));
+    CU_ASSERT_EQUAL(change_count(), 0);
+
+    // Out of the sweep
+    CU_ASSERT_FALSE(change_update(USR_MAX_POS + 1, NEAR));
+    CU_ASSERT_FALSE(change_update(USR_MAX_POS + 1, SENSOR_DIST_MAX));
+}
+
+void change_sight()
+{
+    change_init();
+
+    // Objects appearing and disappearing, even near the largest distance
+    change_update(USR_MIN_POS, SENSOR_DIST_MAX);
+    change_update(USR_MAX_POS, SENSOR_DIST_MAX - 1);
+
+    CU_ASSERT_FALSE(change_update(USR_MIN_POS, SENSOR_DIST_MAX));
+    CU_ASSERT_TRUE(change_update(USR_MIN_POS, SENSOR_DIST_MAX - 1));
+    CU_ASSERT_TRUE(change_update(USR_MAX_POS, SENSOR_DIST_MAX));
+    CU_ASSERT_EQUAL(change_count(), 2);
+}
+
+void change_bitmap()
+{
+    uint32_t    bitmap[CHANGE_WORDS];
+    int_t       pos;
+
+    change_init();
+    change_sweep(SENSOR_DIST_MAX);
+    change_sweep(SENSOR_DIST_MAX);
+
+    CU_ASSERT_EQUAL(change_get_bitmap(bitmap), 0);
+
+    for(pos = USR_MIN_POS; pos <= USR_MAX_POS; ++pos)
+        CU_ASSERT_FALSE(CHANGE_BIT(bitmap, pos));
+
+    // An intruder at the first, a middle and the last position
+    change_update(USR_MIN_POS, NEAR);
+    change_update(USR_MID_POS, NEAR);
+    change_update(USR_MAX_POS, NEAR);
+
+    CU_ASSERT_EQUAL(change_get_bitmap(bitmap), 3);
+
+    for(pos = USR_MIN_POS; pos <= USR_MAX_POS; ++pos)
+        CU_ASSERT_EQUAL(CHANGE_BIT(bitmap, pos),
+                pos == USR_MIN_POS || pos == USR_MID_POS || pos == USR_MAX_POS);
+
+    // Then staying there
+    change_sweep(NEAR);
+    CU_ASSERT_EQUAL(change_count(), USR_MAX_POS - USR_MIN_POS + 1 - 3);
+    change_sweep(NEAR);
+    CU_ASSERT_EQUAL(change_get_bitmap(bitmap), 0);
+    CU_ASSERT_EQUAL(bitmap[0], 0);
+}
+
+void change_sensors()
+{
+    // An object moving 22 cm away between two visits, in ticks of the
+    // simulation
+    const int_t         moved = (CM_TO_DISTANCE(22) * DISTANCE_PERIOD + SYST_PERIOD - 1) / SYST_PERIOD;
+    const sim_echo_t    before[SENSORS_NUM] = { { ECHO_DELAY, NEAR }, { ECHO_DELAY, NEAR } };
+    const sim_echo_t    after[SENSORS_NUM] = { { ECHO_DELAY, NEAR + moved }, { ECHO_DELAY, NEAR + moved } };
+    int_t               i;
+
+    filter_init();
+    change_init();
+
+    sensors_set_bearing(USR_MID_POS);
+    sim_polling_step(before);
+
+    for(i = 0; i < 4; ++i)
+    {
+        sim_polling_step(before);
+        CU_ASSERT_FALSE(change_update(USR_MID_POS, sensors_get_last_measured()));
+    }
+
+    // The change is flagged at the first visit, while the filtered distance
+    // still lags behind it
+    sim_polling_step(after);
+    CU_ASSERT_TRUE(change_update(USR_MID_POS, sensors_get_last_measured()));
+    CU_ASSERT(sensors_get_last_distance() < SIM_DISTANCE(NEAR) + CHANGE_MIN);
+
+    sim_polling_step(after);
+    CU_ASSERT_FALSE(change_update(USR_MID_POS, sensors_get_last_measured()));
+
+    filter_init();
+}
+
+void change_add_suites()
+{
+    CU_pSuite change = CU_add_suite("Change Detection Testing", change_suite_init, change_suite_clean);
+
+    CU_add_test(change, "Threshold Testing", change_threshold);
+    CU_add_test(change, "Nothing in Sight Testing", change_sight);
+    CU_add_test(change, "Bitmap Testing", change_bitmap);
+    CU_add_test(change, "Sensors Changes Testing", change_sensors);
+}
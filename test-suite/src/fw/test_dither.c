@@ -0,0 +1,200 @@
+#include <CUnit/CUnit.h>
+
+#include "hal.h"
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sim.h"
+#include "trigger_stub.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Trigger Dithering Functional Testing
+ * --------------------------------------------------------------------------------
+ *
+ * Sensors send their burst at the end of their trigger pulse, so the echoes
+ * of each step start after the delay chosen at the previous trigger. Echoes
+ * of a foreign sonar or of the other sensor instead arrive at times unrelated
+ * to that delay.
+ */
+
+#define ECHO_WIDTH  (100)   // Width of a real echo in ticks
+#define FOREIGN     (300)   // Tick of a foreign pulse, at each step
+#define CROSSTALK   (60)    // Ticks from the burst of a sensor to the end of
+                            // the echo it causes on the other one
+#define PINGS       (64)    // Steps checked for rejected echoes
+
+// Tick at which the echo of a sensor starts, after its last trigger
+int_t dither_start(int_t id)
+{
+    return (TRIGGER_PULSE + trigger_stub_delays[id] + SYST_PERIOD - 1) / SYST_PERIOD;
+}
+
+// Simulates a step with a real echo on both sensors
+void dither_real()
+{
+    const sim_echo_t echoes[SENSORS_NUM] =
+    {
+        { dither_start(SENSOR_LX), ECHO_WIDTH },
+        { dither_start(SENSOR_RX), ECHO_WIDTH },
+    };
+
+    sim_polling_step(echoes);
+}
+
+// Simulates a step in which a foreign pulse ends the echo of both sensors
+void dither_foreign()
+{
+    const sim_echo_t echoes[SENSORS_NUM] =
+    {
+        { dither_start(SENSOR_LX), FOREIGN - dither_start(SENSOR_LX) },
+        { dither_start(SENSOR_RX), FOREIGN - dither_start(SENSOR_RX) },
+    };
+
+    sim_polling_step(echoes);
+}
+
+// Simulates a step in which the burst of the left sensor ends the echo of the
+// right one
+void dither_crosstalk()
+{
+    const sim_echo_t echoes[SENSORS_NUM] =
+    {
+        { dither_start(SENSOR_LX), ECHO_WIDTH },
+        { dither_start(SENSOR_RX), dither_start(SENSOR_LX) + CROSSTALK - dither_start(SENSOR_RX) },
+    };
+
+    sim_polling_step(echoes);
+}
+
+// Returns the number of the given steps giving a valid echo on a sensor
+int_t dither_accepted(void (*step)(), int_t id)
+{
+    returns_t   returns;
+    int_t       i;
+    int_t       accepted = 0;
+
+    for(i = 0; i < PINGS; ++i)
+    {
+        step();
+
+        if(sensors_get_returns(id, &returns))
+            ++accepted;
+    }
+
+    return accepted;
+}
+
+int dither_suite_init()
+{
+    hal_stub_reset();
+    sensors_init();
+
+    dither_real();
+    dither_real();
+
+    return 0;
+}
+
+int dither_suite_clean()
+{
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    dither_real();
+    dither_real();
+
+    return 0;
+}
+
+void dither_delays()
+{
+    uint_t  first[SENSORS_NUM];
+    bool_t  changed = false;
+    int_t   i;
+    int_t   j;
+
+    sensors_set_dither(0);
+    dither_real();
+
+    CU_ASSERT_EQUAL(trigger_stub_delays[SENSOR_LX], 0);
+    CU_ASSERT_EQUAL(trigger_stub_delays[SENSOR_RX], 0);
+
+    // Each sensor gets its own delay at each trigger, within the maximum
+    sensors_set_dither(TRIGGER_DITHER_MAX + 1);
+    dither_real();
+
+    for(j = 0; j < SENSORS_NUM; ++j)
+        first[j] = trigger_stub_delays[j];
+
+    CU_ASSERT_NOT_EQUAL(first[SENSOR_LX], first[SENSOR_RX]);
+
+    for(i = 0; i < PINGS; ++i)
+    {
+        dither_real();
+
+        for(j = 0; j < SENSORS_NUM; ++j)
+        {
+            CU_ASSERT(trigger_stub_delays[j] <= TRIGGER_DITHER_MAX);
+
+            if(trigger_stub_delays[j] != first[j])
+                changed = true;
+        }
+    }
+
+    CU_ASSERT_TRUE(changed);
+}
+
+void dither_aliasing()
+{
+    // Without dithering a foreign pulse looks like a real object
+    sensors_set_dither(0);
+
+    CU_ASSERT_EQUAL(dither_accepted(dither_foreign, SENSOR_LX), PINGS);
+    CU_ASSERT_EQUAL(dither_accepted(dither_crosstalk, SENSOR_RX), PINGS);
+}
+
+void dither_real_echoes()
+{
+    returns_t returns;
+
+    sensors_set_dither(TRIGGER_DITHER_MAX);
+
+    // Real echoes do not depend on the delays, they are all used once the
+    // first one gives the reference
+    dither_real();
+
+    CU_ASSERT_EQUAL(dither_accepted(dither_real, SENSOR_LX), PINGS);
+    CU_ASSERT_EQUAL(dither_accepted(dither_real, SENSOR_RX), PINGS);
+
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_LX, &returns));
+    CU_ASSERT_EQUAL(returns.echoes[0].width, SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void dither_rejection()
+{
+    sensors_set_dither(TRIGGER_DITHER_MAX);
+
+    // Only the echoes whose delays happen to be close are still accepted
+    CU_ASSERT(dither_accepted(dither_foreign, SENSOR_LX) < PINGS / 4);
+    CU_ASSERT(dither_accepted(dither_foreign, SENSOR_RX) < PINGS / 4);
+    CU_ASSERT(dither_accepted(dither_crosstalk, SENSOR_RX) < PINGS / 4);
+
+    // While the real ones are used again right after
+    dither_real();
+    dither_real();
+
+    CU_ASSERT_EQUAL(dither_accepted(dither_real, SENSOR_RX), PINGS);
+}
+
+void dither_add_suites()
+{
+    CU_pSuite dither = CU_add_suite("Trigger Dithering Functional Testing", dither_suite_init, dither_suite_clean);
+
+    CU_add_test(dither, "Random Delays Testing", dither_delays);
+    CU_add_test(dither, "Aliasing Without Dithering Testing", dither_aliasing);
+    CU_add_test(dither, "Real Echoes Testing", dither_real_echoes);
+    CU_add_test(dither, "Foreign Pulses Rejection Testing", dither_rejection);
+}
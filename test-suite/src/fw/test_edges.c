@@ -0,0 +1,271 @@
+#include <stdlib.h>
+
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+
+#include "edges.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                        Block Edge Detection Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define EDGES_MAX       (256)
+#define SAMPLES_MAX     (1024)
+
+#define PIN_LX          (0x0020)
+#define PIN_RX          (0x2000)
+#define PIN_OTHER       (0x0080)
+
+// An edge as reported to the handler
+typedef struct
+{
+    uint16_t    pin;
+    bool_t      level;
+    uint32_t    index;
+} edge_t;
+
+// Edges found by the detector and by the reference implementation
+typedef struct
+{
+    edge_t  edges[EDGES_MAX];
+    int_t   count;
+} edge_list_t;
+
+static edge_list_t  found;
+static edge_list_t  expected;
+
+static uint16_t     samples[SAMPLES_MAX];
+
+// Handler that records the edges in the list given as data
+void edges_record(void* data, uint16_t pin, bool_t level, uint32_t index)
+{
+    edge_list_t* list = STATIC_CAST(edge_list_t*, data);
+
+    if(list->count >= EDGES_MAX)
+        return;
+
+    list->edges[list->count].pin = pin;
+    list->edges[list->count].level = level;
+    list->edges[list->count].index = index;
+    ++list->count;
+}
+
+// Reference implementation, checks every line of every sample
+void edges_reference(uint16_t mask, const uint16_t* s, uint_t count)
+{
+    uint16_t    last = 0;
+    uint16_t    pin;
+    uint_t      i;
+    int_t       line;
+
+    for(i = 0; i < count; ++i)
+    {
+        for(line = 0; line < 16; ++line)
+        {
+            pin = 1 << line;
+
+            if((mask & pin) && ((s[i] ^ last) & pin))
+                edges_record(&expected, pin, BOOL(s[i] & pin), i);
+        }
+
+        last = s[i];
+    }
+}
+
+// Checks that the detector found exactly the expected edges
+void edges_check()
+{
+    int_t i;
+
+    CU_ASSERT_EQUAL(found.count, expected.count);
+
+    for(i = 0; i < found.count && i < expected.count; ++i)
+    {
+        CU_ASSERT_EQUAL(found.edges[i].pin, expected.edges[i].pin);
+        CU_ASSERT_EQUAL(found.edges[i].level, expected.edges[i].level);
+        CU_ASSERT_EQUAL(found.edges[i].index, expected.edges[i].index);
+    }
+}
+
+// Drives a line high in the given range of samples
+void edges_pulse(uint16_t pin, uint_t start, uint_t end)
+{
+    uint_t i;
+
+    for(i = start; i < end; ++i)
+        samples[i] |= pin;
+}
+
+// Clears the samples and the lists of edges
+void edges_reset(edges_t* edges, uint16_t mask)
+{
+    uint_t i;
+
+    for(i = 0; i < SAMPLES_MAX; ++i)
+        samples[i] = 0;
+
+    found.count = 0;
+    expected.count = 0;
+
+    edges_init(edges, mask, edges_record, &found);
+}
+
+void edges_single_pulse()
+{
+    edges_t edges;
+
+    edges_reset(&edges, PIN_LX);
+    edges_pulse(PIN_LX, 100, 400);
+
+    edges_detect(&edges, samples, SAMPLES_MAX);
+
+    CU_ASSERT_EQUAL(found.count, 2);
+    CU_ASSERT_EQUAL(found.edges[0].level, true);
+    CU_ASSERT_EQUAL(found.edges[0].index, 100);
+    CU_ASSERT_EQUAL(found.edges[1].level, false);
+    CU_ASSERT_EQUAL(found.edges[1].index, 400);
+    CU_ASSERT_EQUAL(edges.index, SAMPLES_MAX);
+}
+
+void edges_block_boundaries()
+{
+    edges_t edges;
+
+    // Edges on the first and the last sample of blocks
+    edges_reset(&edges, PIN_LX | PIN_RX);
+    edges_pulse(PIN_LX, 0, EDGES_BLOCK - 1);
+    edges_pulse(PIN_RX, EDGES_BLOCK, 3 * EDGES_BLOCK);
+    edges_pulse(PIN_LX, 4 * EDGES_BLOCK - 1, 4 * EDGES_BLOCK);
+
+    edges_reference(PIN_LX | PIN_RX, samples, SAMPLES_MAX);
+    edges_detect(&edges, samples, SAMPLES_MAX);
+
+    CU_ASSERT_EQUAL(found.count, 6);
+    edges_check();
+}
+
+void edges_same_sample()
+{
+    edges_t edges;
+
+    // Both lines change on the same sample, lines not in the mask are ignored
+    edges_reset(&edges, PIN_LX | PIN_RX);
+    edges_pulse(PIN_LX | PIN_RX, 50, 60);
+    edges_pulse(PIN_OTHER, 10, 500);
+
+    edges_reference(PIN_LX | PIN_RX, samples, SAMPLES_MAX);
+    edges_detect(&edges, samples, SAMPLES_MAX);
+
+    CU_ASSERT_EQUAL(found.count, 4);
+    edges_check();
+}
+
+void edges_split_calls()
+{
+    edges_t edges;
+    uint_t  i, len;
+
+    // Samples are given in chunks not aligned to the blocks
+    edges_reset(&edges, PIN_LX);
+    edges_pulse(PIN_LX, 5, 6);
+    edges_pulse(PIN_LX, 30, 77);
+    edges_pulse(PIN_LX, 78, 900);
+
+    edges_reference(PIN_LX, samples, SAMPLES_MAX);
+
+    for(i = 0; i < SAMPLES_MAX; i += len)
+    {
+        len = (i % 7) + 1;
+        if(i + len > SAMPLES_MAX)
+            len = SAMPLES_MAX - i;
+
+        edges_detect(&edges, samples + i, len);
+    }
+
+    edges_check();
+}
+
+void edges_ring()
+{
+    edges_t edges;
+    uint_t  read;
+
+    // A pulse that wraps around the end of the circular buffer
+    edges_reset(&edges, PIN_RX);
+    edges_pulse(PIN_RX, SAMPLES_MAX - 10, SAMPLES_MAX);
+    edges_pulse(PIN_RX, 0, 20);
+
+    // Indexes count the samples from the first one scanned
+    read = edges_detect_ring(&edges, samples, SAMPLES_MAX, SAMPLES_MAX - 100, SAMPLES_MAX - 50);
+    CU_ASSERT_EQUAL(read, SAMPLES_MAX - 50);
+    CU_ASSERT_EQUAL(found.count, 0);
+
+    read = edges_detect_ring(&edges, samples, SAMPLES_MAX, read, 50);
+    CU_ASSERT_EQUAL(read, 50);
+    CU_ASSERT_EQUAL(found.count, 2);
+    CU_ASSERT_EQUAL(found.edges[0].index, 90);
+    CU_ASSERT_EQUAL(found.edges[0].level, true);
+    CU_ASSERT_EQUAL(found.edges[1].index, 120);
+    CU_ASSERT_EQUAL(found.edges[1].level, false);
+
+    // Nothing new to scan
+    read = edges_detect_ring(&edges, samples, SAMPLES_MAX, read, read);
+    CU_ASSERT_EQUAL(found.count, 2);
+    CU_ASSERT_EQUAL(edges.index, 150);
+}
+
+void edges_random()
+{
+    edges_t edges;
+    uint_t  i, len;
+    int_t   run;
+
+    srand(17);
+
+    for(run = 0; run < 20; ++run)
+    {
+        edges_reset(&edges, PIN_LX | PIN_RX);
+
+        // Lines keep their level for random lengths, all lines are noisy
+        for(i = 0; i < SAMPLES_MAX; ++i)
+        {
+            samples[i] = i > 0 ? samples[i - 1] : 0;
+
+            if(rand() % 40 == 0)
+                samples[i] ^= PIN_LX;
+            if(rand() % 40 == 0)
+                samples[i] ^= PIN_RX;
+            if(rand() % 2 == 0)
+                samples[i] ^= PIN_OTHER;
+        }
+
+        edges_reference(PIN_LX | PIN_RX, samples, SAMPLES_MAX);
+
+        for(i = 0; i < SAMPLES_MAX; i += len)
+        {
+            len = rand() % (3 * EDGES_BLOCK) + 1;
+            if(i + len > SAMPLES_MAX)
+                len = SAMPLES_MAX - i;
+
+            edges_detect(&edges, samples + i, len);
+        }
+
+        edges_check();
+    }
+}
+
+void edges_add_suites()
+{
+    CU_pSuite edges = CU_add_suite("Block Edge Detection Functional Testing", NULL, NULL);
+
+    CU_add_test(edges, "Single Pulse Testing", edges_single_pulse);
+    CU_add_test(edges, "Block Boundaries Testing", edges_block_boundaries);
+    CU_add_test(edges, "Same Sample Testing", edges_same_sample);
+    CU_add_test(edges, "Split Calls Testing", edges_split_calls);
+    CU_add_test(edges, "Circular Buffer Testing", edges_ring);
+    CU_add_test(edges, "Random Testing", edges_random);
+}
@@ -0,0 +1,239 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "filter.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Bearing Filters Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define ECHO_DELAY  (10)
+#define FAR         (100 + 2 * FILTER_GATE_MAX)
+
+// Number of elements of an array
+#define FILTER_COUNT(array) STATIC_CAST(int_t, sizeof(array) / sizeof((array)[0]))
+
+// Recorded sequence of a steady object, with a spurious echo of another sonar
+// and a missed one, then the object moving away
+static const distance_t recorded[] =
+{
+    100, 101, 99, 100, 4 * FAR, 100, 102, SENSOR_DIST_MAX, 101, 100,
+    FAR, FAR + 1, FAR, FAR - 1, FAR,
+};
+
+// Feeds a sequence to the filters at a bearing, copying their outputs
+void filter_feed(int_t bearing, const distance_t input[], distance_t output[], int_t count)
+{
+    int_t i;
+
+    for(i = 0; i < count; ++i)
+        output[i] = filter_update(bearing, input[i]);
+}
+
+// Sets the chain of the given filters
+#define FILTER_CHAIN(...) \
+    do { \
+        const filter_kind_t kinds[] = { __VA_ARGS__ }; \
+        CU_ASSERT_TRUE(filter_set_chain(kinds, FILTER_COUNT(kinds))); \
+    } while(0)
+
+int filter_suite_init()
+{
+    filter_init();
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    return 0;
+}
+
+int filter_suite_clean()
+{
+    filter_init();
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void filter_chain()
+{
+    const filter_kind_t long_chain[FILTER_STAGES_MAX + 1] = { FILTER_EMA };
+    const filter_kind_t unknown[] = { FILTER_EMA, FILTER_KINDS };
+    const filter_kind_t defaults[] = FILTER_CHAIN_DEFAULT;
+    filter_kind_t       kinds[FILTER_STAGES_MAX];
+    distance_t          output[FILTER_COUNT(recorded)];
+
+    CU_ASSERT_EQUAL(filter_get_chain(kinds), FILTER_COUNT(defaults));
+    CU_ASSERT_EQUAL(kinds[0], defaults[0]);
+
+    CU_ASSERT_FALSE(filter_set_chain(long_chain, FILTER_COUNT(long_chain)));
+    CU_ASSERT_FALSE(filter_set_chain(unknown, FILTER_COUNT(unknown)));
+    CU_ASSERT_EQUAL(filter_get_chain(kinds), FILTER_COUNT(defaults));
+
+    // No filters at all
+    CU_ASSERT_TRUE(filter_set_chain(NULL, 0));
+    filter_feed(0, recorded, output, FILTER_COUNT(recorded));
+    CU_ASSERT_EQUAL(output[4], recorded[4]);
+    CU_ASSERT_EQUAL(output[7], recorded[7]);
+
+    // Bearings out of the motor positions are never filtered
+    FILTER_CHAIN(FILTER_EMA);
+    CU_ASSERT_EQUAL(filter_update(USR_MAX_POS + 1, 100), 100);
+    CU_ASSERT_EQUAL(filter_update(USR_MAX_POS + 1, 200), 200);
+
+    CU_ASSERT(filter_memory(FILTER_MEDIAN) >= FILTER_BEARINGS * 3 * sizeof(distance_t));
+    CU_ASSERT(filter_memory(FILTER_EMA) >= FILTER_BEARINGS * sizeof(distance_t));
+    CU_ASSERT(filter_memory(FILTER_GATE) >= FILTER_BEARINGS * sizeof(distance_t));
+    CU_ASSERT_EQUAL(filter_memory(FILTER_KINDS), 0);
+}
+
+void filter_median_stage()
+{
+    distance_t output[FILTER_COUNT(recorded)];
+
+    FILTER_CHAIN(FILTER_MEDIAN);
+    filter_feed(0, recorded, output, FILTER_COUNT(recorded));
+
+    // Single spurious or missed echoes are removed
+    CU_ASSERT_EQUAL(output[0], 100);
+    CU_ASSERT_EQUAL(output[2], 100);
+    CU_ASSERT_EQUAL(output[4], 100);
+    CU_ASSERT_EQUAL(output[5], 100);
+    CU_ASSERT_EQUAL(output[7], 102);
+    CU_ASSERT_EQUAL(output[8], 102);
+
+    // A real movement is followed with one distance of delay
+    CU_ASSERT_EQUAL(output[10], 101);
+    CU_ASSERT_EQUAL(output[11], FAR);
+}
+
+void filter_ema_stage()
+{
+    distance_t output[FILTER_COUNT(recorded)];
+
+    FILTER_CHAIN(FILTER_EMA);
+    filter_feed(0, recorded, output, FILTER_COUNT(recorded));
+
+    // Starts from the first distance, then moves most of the way
+    CU_ASSERT_EQUAL(output[0], 100);
+    CU_ASSERT_EQUAL(output[1], 101);
+    CU_ASSERT_EQUAL(output[2], 99);
+
+    // Spurious echoes pass almost whole
+    CU_ASSERT(output[4] > FAR);
+}
+
+void filter_gate_stage()
+{
+    distance_t output[FILTER_COUNT(recorded)];
+
+    FILTER_CHAIN(FILTER_GATE);
+    filter_feed(0, recorded, output, FILTER_COUNT(recorded));
+
+    CU_ASSERT_EQUAL(output[3], 100);
+    CU_ASSERT_EQUAL(output[4], 100);
+    CU_ASSERT_EQUAL(output[5], 100);
+    CU_ASSERT_EQUAL(output[7], 102);
+
+    // A movement is accepted after FILTER_GATE_HOLD distances
+    CU_ASSERT_EQUAL(output[10], 100);
+    CU_ASSERT_EQUAL(output[11], 100);
+    CU_ASSERT_EQUAL(output[12], 100);
+    CU_ASSERT_EQUAL(output[13], FAR - 1);
+    CU_ASSERT_EQUAL(output[14], FAR);
+}
+
+void filter_robust_chain()
+{
+    distance_t  output[FILTER_COUNT(recorded)];
+    int_t       i;
+
+    FILTER_CHAIN(FILTER_MEDIAN, FILTER_GATE, FILTER_EMA);
+    filter_feed(0, recorded, output, FILTER_COUNT(recorded));
+
+    // The steady object is never lost
+    for(i = 0; i < 11; ++i)
+        CU_ASSERT(output[i] >= 99 && output[i] <= 102);
+
+    // The movement is followed once past the gate
+    CU_ASSERT(output[14] > output[10] + FILTER_GATE_MAX);
+}
+
+void filter_bearings()
+{
+    const distance_t    near[] = { 100, 100, 100, 100 };
+    const distance_t    far[] = { 500, 500, 500, 500 };
+    distance_t          output[4];
+    int_t               i;
+
+    FILTER_CHAIN(FILTER_MEDIAN, FILTER_EMA);
+
+    // Alternating bearings do not mix
+    for(i = 0; i < 4; ++i)
+    {
+        filter_feed(10, near + i, output + i, 1);
+        CU_ASSERT_EQUAL(output[i], 100);
+
+        filter_feed(11, far + i, output + i, 1);
+        CU_ASSERT_EQUAL(output[i], 500);
+    }
+
+    // Changing the chain forgets all the bearings
+    FILTER_CHAIN(FILTER_EMA);
+    CU_ASSERT_EQUAL(filter_update(10, 300), 300);
+}
+
+void filter_sensors()
+{
+    const sim_echo_t near[SENSORS_NUM] = { { ECHO_DELAY, 100 }, { ECHO_DELAY, 100 } };
+    const sim_echo_t far[SENSORS_NUM] = { { ECHO_DELAY, 300 }, { ECHO_DELAY, 300 } };
+    int_t   i;
+
+    // A sweep over two bearings, the near object at the first one and the far
+    // one at the second, keeps both. The bearing set before a step is the one
+    // of the trigger sent at its end, whose echoes come at the next step.
+    sensors_set_bearing(USR_MIN_POS);
+    sim_polling_step(far);
+
+    FILTER_CHAIN(FILTER_EMA);
+
+    for(i = 0; i < 6; ++i)
+    {
+        sensors_set_bearing(USR_MIN_POS + 1);
+        sim_polling_step(near);
+
+        CU_ASSERT_EQUAL(sensors_get_last_distance(), SIM_DISTANCE(100));
+
+        sensors_set_bearing(USR_MIN_POS);
+        sim_polling_step(far);
+
+        CU_ASSERT_EQUAL(sensors_get_last_distance(), SIM_DISTANCE(300));
+    }
+
+    // The far object moving closer is averaged only with itself
+    sensors_set_bearing(USR_MIN_POS + 1);
+    sim_polling_step(near);
+    sim_polling_step(near);
+    CU_ASSERT_EQUAL(sensors_get_last_distance(),
+            SIM_DISTANCE(300) - Q15_MUL(SIM_DISTANCE(200), FILTER_EMA_WEIGHT));
+}
+
+void filter_add_suites()
+{
+    CU_pSuite filter = CU_add_suite("Bearing Filters Testing", filter_suite_init, filter_suite_clean);
+
+    CU_add_test(filter, "Chain Testing", filter_chain);
+    CU_add_test(filter, "Median Testing", filter_median_stage);
+    CU_add_test(filter, "Moving Average Testing", filter_ema_stage);
+    CU_add_test(filter, "Gate Testing", filter_gate_stage);
+    CU_add_test(filter, "Robust Chain Testing", filter_robust_chain);
+    CU_add_test(filter, "Bearings Testing", filter_bearings);
+    CU_add_test(filter, "Sensors Distance Testing", filter_sensors);
+}
@@ -0,0 +1,113 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "fixed.h"
+#include "motor.h"
+#include "sensor.h"
+#include "trigger.h"
+#include "filter.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Fixed Point Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define ECHO_DELAY  (10)
+
+int fixed_suite_init()
+{
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    return 0;
+}
+
+int fixed_suite_clean()
+{
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void fixed_constants()
+{
+    CU_ASSERT_EQUAL(Q15(0.5), 16384);
+    CU_ASSERT_EQUAL(Q15(-0.5), -16384);
+    CU_ASSERT_EQUAL(Q15(0.8), 26214);
+    CU_ASSERT_EQUAL(Q16(25.0), 25 * Q16_ONE);
+    CU_ASSERT_EQUAL(Q16(-1.5), -3 * Q16_ONE / 2);
+}
+
+void fixed_products()
+{
+    // Rounded to the nearest, halves up, for either sign
+    CU_ASSERT_EQUAL(Q15_MUL(3, Q15(0.5)), 2);
+    CU_ASSERT_EQUAL(Q15_MUL(-3, Q15(0.5)), -1);
+    CU_ASSERT_EQUAL(Q15_MUL(10, Q15(0.8)), 8);
+    CU_ASSERT_EQUAL(Q15_MUL(-10, Q15(0.8)), -8);
+    CU_ASSERT_EQUAL(Q15_MUL(41200, Q15(0.8)), 32959);
+
+    CU_ASSERT_EQUAL(Q16_MUL(7, Q16(0.25)), 2);
+    CU_ASSERT_EQUAL(Q16_MUL(-7, Q16(0.25)), -2);
+    CU_ASSERT_EQUAL(Q16_MUL(100000, Q16(1000.0)), 100000000);
+
+    // Blending moves towards the target, and stays on it
+    CU_ASSERT_EQUAL(Q15_BLEND(100, 200, Q15(0.8)), 180);
+    CU_ASSERT_EQUAL(Q15_BLEND(200, 100, Q15(0.8)), 120);
+    CU_ASSERT_EQUAL(Q15_BLEND(100, 100, Q15(0.8)), 100);
+}
+
+void fixed_motor()
+{
+    int_t   pos;
+
+    // Each user position is a motor step and back
+    for(pos = USR_MIN_POS; pos <= USR_MAX_POS; ++pos)
+    {
+        CU_ASSERT_EQUAL(USR_TO_MOTOR_POS(pos), MOTOR_MIN + pos * MOTOR_STP);
+        CU_ASSERT_EQUAL(MOTOR_TO_USR_POS(USR_TO_MOTOR_POS(pos)), pos);
+    }
+
+    CU_ASSERT_EQUAL(MOTOR_TO_USR_POS(MOTOR_MID), USR_MID_POS);
+    CU_ASSERT_EQUAL(MOTOR_TO_USR_POS(MOTOR_MAX), USR_MAX_POS);
+}
+
+void fixed_distance()
+{
+    const sim_echo_t near[SENSORS_NUM] = { { ECHO_DELAY, 100 }, { ECHO_DELAY, 100 } };
+    const sim_echo_t far[SENSORS_NUM] = { { ECHO_DELAY, 200 }, { ECHO_DELAY, 200 } };
+    const filter_kind_t ema[] = { FILTER_EMA };
+    int_t   i;
+
+    filter_set_chain(ema, 1);
+
+    // The distance converges to a steady object and stays there
+    for(i = 0; i < 10; ++i)
+        sim_polling_step(near);
+
+    CU_ASSERT_EQUAL(sensors_get_last_distance(), SIM_DISTANCE(100));
+
+    // Then moves most of the way to a new one at each step
+    sim_polling_step(far);
+    CU_ASSERT_EQUAL(sensors_get_last_distance(), SIM_DISTANCE(180));
+
+    sim_polling_step(far);
+    CU_ASSERT_EQUAL(sensors_get_last_distance(), SIM_DISTANCE(196));
+
+    filter_init();
+}
+
+void fixed_add_suites()
+{
+    CU_pSuite fixed = CU_add_suite("Fixed Point Testing", fixed_suite_init, fixed_suite_clean);
+
+    CU_add_test(fixed, "Constants Testing", fixed_constants);
+    CU_add_test(fixed, "Products Testing", fixed_products);
+    CU_add_test(fixed, "Motor Positions Testing", fixed_motor);
+    CU_add_test(fixed, "Distance Filter Testing", fixed_distance);
+}
@@ -0,0 +1,194 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "echo_fsm.h"
+#include "trigger.h"
+#include "hal_stub.h"
+#include "sim.h"
+#include "trigger_stub.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                              FSM Conformance Test
+ * --------------------------------------------------------------------------------
+ */
+
+// Possible inputs to state machine
+typedef enum
+{
+    REC_TRIG = 0,
+    REC_NTRIG,
+    NREC_TRIG,
+    NREC_NTRIG,
+    STATE_INPUT_MAX,    // Used only to stop testing
+} sensor_state_input_t;
+
+// Converts an input in the pair of boolean variables
+// accepted by the state machine
+#define IN_TO_TRIGGER_SENT(in) (in == REC_TRIG || in == NREC_TRIG)
+#define IN_TO_RECORDING(in) (in == REC_TRIG || in == REC_NTRIG)
+
+// State Machine expected behavior container structure
+typedef struct
+{
+    sensor_echo_state_t state_id;       // Current state id
+    sensor_echo_state_t next_state[4];  // Expected next state, based on the input
+    bool_t              next_output[4]; // Expected next output, based on the input
+} sm_state_t;
+
+// Actual expected behavior, see enum declarations in sensor.h
+// file to see what these numbers are mapped into
+const sm_state_t sm[] =
+{
+    {0,{3,3,2,1},{0,0,1,1}},
+    {1,{3,3,2,1},{0,0,1,1}},
+    {2,{3,3,2,1},{0,0,1,1}},
+    {3,{3,3,0,0},{0,0,1,1}},
+};
+
+#define ECHO_DELAY  (10)
+#define ECHO_WIDTH  (20)
+
+// Echoes giving each input to a sensor during a whole step. A sensor that is
+// recording has already seen the start of the echo, so the REC_TRIG input
+// never happens and it is checked on the transition table only.
+static const sim_echo_t fsm_echoes[STATE_INPUT_MAX] =
+{
+    [REC_TRIG]      = { -1, STEP_PERIOD_TICKS + 1 },
+    [REC_NTRIG]     = { -1, STEP_PERIOD_TICKS + 1 },
+    [NREC_TRIG]     = { 0, -1 },
+    [NREC_NTRIG]    = { ECHO_DELAY, ECHO_WIDTH },
+};
+
+// Simulates a step giving the same input to all the sensors
+void fsm_step(sensor_state_input_t in)
+{
+    sim_echo_t  echoes[SENSORS_NUM];
+    int_t       i;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+        echoes[i] = fsm_echoes[in];
+
+    sim_polling_step(echoes);
+}
+
+// Brings all the sensors in the given state through the real inputs
+void fsm_reach(sensor_echo_state_t state)
+{
+    // From any state two good echoes give SENSOR_ECHO_OK
+    fsm_step(NREC_NTRIG);
+    fsm_step(NREC_NTRIG);
+
+    if(state == SENSOR_ECHO_LOST)
+        fsm_step(NREC_TRIG);
+
+    if(state == SENSOR_ECHO_LONG || state == SENSOR_ECHO_NEXT_OK)
+        fsm_step(REC_NTRIG);
+
+    if(state == SENSOR_ECHO_NEXT_OK)
+        fsm_step(NREC_NTRIG);
+}
+
+int fsm_suite_init()
+{
+    hal_stub_reset();
+    sensors_init();
+
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+
+    return 0;
+}
+
+int fsm_suite_clean()
+{
+    // Leaves the sensors in the OK state for the following suites
+    fsm_reach(SENSOR_ECHO_OK);
+
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+
+    return 0;
+}
+
+// Tests if the transition table gives the expected behavior
+void conformance_test_table()
+{
+    sensor_echo_state_t state_id;
+    sensor_echo_state_t next;
+    int_t               in;
+
+    for(state_id = 0; state_id < SENSOR_ECHO_STATES; ++state_id)
+    {
+        for(in = 0; in < STATE_INPUT_MAX; ++in)
+        {
+            next = ECHO_FSM_STEP(state_id, IN_TO_RECORDING(in), IN_TO_TRIGGER_SENT(in));
+
+            // Moved to correct state
+            CU_ASSERT_EQUAL(next, sm[state_id].next_state[in]);
+            // Obtained correct output
+            CU_ASSERT_EQUAL(ECHO_FSM_TRIGGER(next), sm[state_id].next_output[in]);
+        }
+    }
+}
+
+// Tests if the sensors implement the given state, driving them through echoes
+void conformance_test_state(const sensor_echo_state_t state_id)
+{
+    int_t in;
+    int_t i;
+
+    for(in = REC_NTRIG; in < STATE_INPUT_MAX; ++in)
+    {
+        // Move to starting state
+        fsm_reach(state_id);
+
+        for(i = 0; i < SENSORS_NUM; ++i)
+            CU_ASSERT_EQUAL_FATAL(sensors_get_state(i), state_id);
+
+        // Update function
+        fsm_step(in);
+
+        for(i = 0; i < SENSORS_NUM; ++i)
+        {
+            // Moved to correct state
+            CU_ASSERT_EQUAL(sensors_get_state(i), sm[state_id].next_state[in]);
+            // Obtained correct output
+            CU_ASSERT_EQUAL(BOOL(trigger_stub_last & TRIGGER_SENSOR(i)),
+                    sm[state_id].next_output[in]);
+        }
+    }
+}
+
+void conformance_test_state_nok()
+{
+    conformance_test_state(SENSOR_ECHO_NEXT_OK);
+}
+
+void conformance_test_state_ok()
+{
+    conformance_test_state(SENSOR_ECHO_OK);
+}
+
+void conformance_test_state_lost()
+{
+    conformance_test_state(SENSOR_ECHO_LOST);
+}
+
+void conformance_test_state_long()
+{
+    conformance_test_state(SENSOR_ECHO_LONG);
+}
+
+void fsm_add_suites()
+{
+    CU_pSuite conformance = CU_add_suite("FSM Conformance Test", fsm_suite_init, fsm_suite_clean);
+
+    CU_add_test(conformance, "Transition Table Conformance Test", conformance_test_table);
+    CU_add_test(conformance, "State NEXT_OK Conformance Test", conformance_test_state_nok);
+    CU_add_test(conformance, "State OK      Conformance Test", conformance_test_state_ok);
+    CU_add_test(conformance, "State LOST    Conformance Test", conformance_test_state_lost);
+    CU_add_test(conformance, "State LONG    Conformance Test", conformance_test_state_long);
+}
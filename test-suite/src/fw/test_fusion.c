@@ -0,0 +1,210 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Sensors Fusion Unit Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t triangolation(const distance_t distances[], int_t count);
+
+#define FUSION_COUNT(distances) (STATIC_CAST(int_t, sizeof(distances) / sizeof(distances[0])))
+
+// Distances below are given in systicks, so that the sensors separation
+// compares the same with __SENSOR_HIRES__
+#define FUSION_TICKS(ticks)     ECHO_US_TO_TICKS((ticks) * SYST_PERIOD)
+
+void fusion_nothing()
+{
+    const distance_t far[] = { SENSOR_DIST_MAX, SENSOR_DIST_MAX + 10, SENSOR_DIST_MAX };
+
+    CU_ASSERT_EQUAL(triangolation(NULL, 0), SENSOR_DIST_MAX);
+    CU_ASSERT_EQUAL(triangolation(far, FUSION_COUNT(far)), SENSOR_DIST_MAX);
+}
+
+void fusion_two_sensors()
+{
+    const distance_t same[] = { FUSION_TICKS(100), FUSION_TICKS(102) };
+    const distance_t different[] = { FUSION_TICKS(100), FUSION_TICKS(120) };
+    const distance_t negative[] = { -5, 2 };
+    const distance_t one[] = { SENSOR_DIST_MAX, FUSION_TICKS(30) };
+
+    // Same behavior of the original two sensors triangolation
+    CU_ASSERT_EQUAL(triangolation(same, FUSION_COUNT(same)), FUSION_TICKS(101));
+    CU_ASSERT_EQUAL(triangolation(different, FUSION_COUNT(different)), FUSION_TICKS(100));
+    CU_ASSERT_EQUAL(triangolation(negative, FUSION_COUNT(negative)), 1);
+    CU_ASSERT_EQUAL(triangolation(one, FUSION_COUNT(one)), FUSION_TICKS(30));
+}
+
+void fusion_many_sensors()
+{
+    const distance_t single[] = { FUSION_TICKS(50) };
+    const distance_t group[] = {
+            FUSION_TICKS(60), FUSION_TICKS(62), FUSION_TICKS(61), FUSION_TICKS(200) };
+    const distance_t nearest[] = {
+            FUSION_TICKS(200), FUSION_TICKS(80), SENSOR_DIST_MAX, FUSION_TICKS(40), FUSION_TICKS(90) };
+
+    CU_ASSERT_EQUAL(triangolation(single, FUSION_COUNT(single)), FUSION_TICKS(50));
+
+    // Only the sensors seeing the nearest object are averaged
+    CU_ASSERT_EQUAL(triangolation(group, FUSION_COUNT(group)), FUSION_TICKS(61));
+    CU_ASSERT_EQUAL(triangolation(nearest, FUSION_COUNT(nearest)), FUSION_TICKS(40));
+}
+
+/* --------------------------------------------------------------------------------
+ *                      Two Sensors Triangolation Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define LX_MIN  0
+#define LX_MAX  SENSOR_DIST_MAX
+#define RX_MIN  0
+#define RX_MAX  SENSOR_DIST_MAX
+
+#define LX_NOMINAL ((LX_MIN + LX_MAX) / 2)
+#define RX_NOMINAL ((RX_MIN + RX_MAX) / 2)
+
+#define LX_EPSILON  ((LX_MAX - LX_MIN) / 20)
+#define RX_EPSILON  ((RX_MAX - RX_MIN) / 20)
+
+#define LX_BOUNDARY_MIN (LX_MIN + LX_EPSILON)
+#define LX_BOUNDARY_MAX (LX_MAX - LX_EPSILON)
+
+#define RX_BOUNDARY_MIN (RX_MIN + RX_EPSILON)
+#define RX_BOUNDARY_MAX (RX_MAX - RX_EPSILON)
+
+#define LX_ROBUSTNESS_MIN (LX_MIN - LX_EPSILON)
+#define LX_ROBUSTNESS_MAX (LX_MAX + LX_EPSILON)
+
+#define RX_ROBUSTNESS_MIN (RX_MIN - RX_EPSILON)
+#define RX_ROBUSTNESS_MAX (RX_MAX + RX_EPSILON)
+
+// Triangolation of the distances measured by a pair of sensors
+distance_t fusion_pair(distance_t dist_lx, distance_t dist_rx)
+{
+    const distance_t distances[] = { dist_lx, dist_rx };
+
+    return triangolation(distances, FUSION_COUNT(distances));
+}
+
+void fusion_pair_nominal()
+{
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_NOMINAL), LX_NOMINAL);
+}
+
+void fusion_pair_boundary()
+{
+    // Testing LX boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX, RX_NOMINAL), RX_NOMINAL);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN, RX_NOMINAL), LX_MIN);
+
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX, RX_NOMINAL), RX_NOMINAL);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN, RX_NOMINAL), LX_BOUNDARY_MIN);
+
+    // Testing RX boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_MAX), LX_NOMINAL);
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_MIN), RX_MIN);
+
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_BOUNDARY_MAX), LX_NOMINAL);
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_BOUNDARY_MIN), RX_BOUNDARY_MIN);
+}
+
+void fusion_pair_robustness()
+{
+    // Testing LX robustness
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX, RX_NOMINAL), RX_NOMINAL);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN, RX_NOMINAL), LX_MIN);
+
+    // Testing RX robustness
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_ROBUSTNESS_MAX), LX_NOMINAL);
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL, RX_ROBUSTNESS_MIN), RX_MIN);
+}
+
+void fusion_pair_worstcase()
+{
+    // Testing LX max boundary - RX max boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX,          RX_MAX),            RX_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX,          RX_BOUNDARY_MAX),   RX_BOUNDARY_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX, RX_MAX),            LX_BOUNDARY_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX, RX_BOUNDARY_MAX),   LX_BOUNDARY_MAX);
+
+    // Testing LX max boundary - RX min boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX,          RX_MIN),            RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX,          RX_BOUNDARY_MIN),   RX_BOUNDARY_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX, RX_MIN),            RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX, RX_BOUNDARY_MIN),   RX_BOUNDARY_MIN);
+
+    // Testing LX min boundary - RX max boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN,          RX_MAX),            LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN,          RX_BOUNDARY_MAX),   LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN, RX_MAX),            LX_BOUNDARY_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN, RX_BOUNDARY_MAX),   LX_BOUNDARY_MIN);
+
+    // Testing LX min boundary - RX min boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN,          RX_MIN),            RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN,          RX_BOUNDARY_MIN),   LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN, RX_MIN),            RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN, RX_BOUNDARY_MIN),   LX_BOUNDARY_MIN);
+}
+
+void fusion_pair_wc_robustness()
+{
+    // Testing LX max boundary - RX max boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX,   RX_ROBUSTNESS_MAX), RX_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX,   RX_MAX),            LX_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX,   RX_BOUNDARY_MAX),   RX_BOUNDARY_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX,              RX_ROBUSTNESS_MAX), LX_MAX);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX,     RX_ROBUSTNESS_MAX), LX_BOUNDARY_MAX);
+
+    // Testing LX max boundary - RX min boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX,   RX_ROBUSTNESS_MIN), RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX,   RX_MIN),            RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MAX,   RX_BOUNDARY_MIN),   RX_BOUNDARY_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MAX,              RX_ROBUSTNESS_MIN), RX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MAX,     RX_ROBUSTNESS_MIN), RX_MIN);
+
+    // Testing LX min boundary - RX max boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN,   RX_ROBUSTNESS_MAX), LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN,   RX_MAX),            LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN,   RX_BOUNDARY_MAX),   LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN,              RX_ROBUSTNESS_MAX), LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN,     RX_ROBUSTNESS_MAX), LX_BOUNDARY_MIN);
+
+    // Testing LX min boundary - RX min boundary
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN,   RX_ROBUSTNESS_MIN), LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN,   RX_MIN),            LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_ROBUSTNESS_MIN,   RX_BOUNDARY_MIN),   LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_MIN,              RX_ROBUSTNESS_MIN), LX_MIN);
+    CU_ASSERT_EQUAL(fusion_pair(LX_BOUNDARY_MIN,     RX_ROBUSTNESS_MIN), RX_MIN);
+}
+
+void fusion_pair_random()
+{
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL-1, RX_NOMINAL+1), (RX_NOMINAL+LX_NOMINAL) / 2);
+    CU_ASSERT_EQUAL(fusion_pair(LX_NOMINAL+1, RX_NOMINAL-1), (RX_NOMINAL+LX_NOMINAL) / 2);
+}
+
+void fusion_add_suites()
+{
+    CU_pSuite fusion = CU_add_suite("Sensors Fusion Unit Testing", NULL, NULL);
+
+    CU_add_test(fusion, "No Object Testing", fusion_nothing);
+    CU_add_test(fusion, "Two Sensors Testing", fusion_two_sensors);
+    CU_add_test(fusion, "Many Sensors Testing", fusion_many_sensors);
+
+    CU_pSuite pair = CU_add_suite("Two Sensors Triangolation Functional Testing", NULL, NULL);
+
+    CU_add_test(pair, "Nominal Testing", fusion_pair_nominal);
+    CU_add_test(pair, "Boundary Testing", fusion_pair_boundary);
+    CU_add_test(pair, "Robustness Testing", fusion_pair_robustness);
+    CU_add_test(pair, "Worst-Case Testing", fusion_pair_worstcase);
+    CU_add_test(pair, "Worst-Case Robustness Testing", fusion_pair_wc_robustness);
+    CU_add_test(pair, "Random Testing", fusion_pair_random);
+}
@@ -0,0 +1,206 @@
+#include <CUnit/CUnit.h>
+
+#include "hal.h"
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "geometry.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Geometric Triangolation Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Time elapsed between the trigger and the start of the echo
+#define ECHO_DELAY  (500)
+
+// Angle units between two motor positions
+#define POS_UNITS   (GEO_TURN / 2 / USR_RANGE)
+
+// Simulated time of the capture timer
+static stamp_t now;
+
+// Simulates a whole step in which the sensors see an object at the given
+// distances in mm, or nothing if negative
+void geo_step(long_int_t lx, long_int_t rx)
+{
+    if(lx >= 0)
+    {
+        sensors_echo_edge(SENSOR_LX, true, now + ECHO_DELAY);
+        sensors_echo_edge(SENSOR_LX, false, now + ECHO_DELAY + SOUND_MM_TO_US(lx));
+    }
+
+    if(rx >= 0)
+    {
+        sensors_echo_edge(SENSOR_RX, true, now + ECHO_DELAY);
+        sensors_echo_edge(SENSOR_RX, false, now + ECHO_DELAY + SOUND_MM_TO_US(rx));
+    }
+
+    now += STEP_PERIOD;
+    sensors_send_trigger();
+}
+
+int geo_suite_init()
+{
+    hal_stub_reset();
+    sensors_init();
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    now = 0;
+    sensors_set_bearing(USR_MID_POS);
+    sensors_send_trigger();
+
+    return 0;
+}
+
+int geo_suite_clean()
+{
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void geo_sqrt()
+{
+    uint32_t    n;
+    uint32_t    root;
+
+    for(n = 0; n < 200000; ++n)
+    {
+        root = geo_isqrt(n);
+        CU_ASSERT(root * root <= n && (root + 1) * (root + 1) > n);
+    }
+
+    CU_ASSERT_EQUAL(geo_isqrt(0xFFFFFFFFul), 65535);
+    CU_ASSERT_EQUAL(geo_isqrt(65535ul * 65535ul), 65535);
+    CU_ASSERT_EQUAL(geo_isqrt(65535ul * 65535ul - 1), 65534);
+}
+
+void geo_trigonometry()
+{
+    int_t   a;
+
+    CU_ASSERT_EQUAL(geo_sin(0), 0);
+    CU_ASSERT_EQUAL(geo_sin(GEO_QUARTER), GEO_ONE);
+    CU_ASSERT_EQUAL(geo_sin(2 * GEO_QUARTER), 0);
+    CU_ASSERT_EQUAL(geo_sin(3 * GEO_QUARTER), -GEO_ONE);
+    CU_ASSERT_EQUAL(geo_sin(-GEO_QUARTER), -GEO_ONE);
+    CU_ASSERT_EQUAL(geo_cos(0), GEO_ONE);
+    CU_ASSERT_EQUAL(geo_cos(2 * GEO_QUARTER), -GEO_ONE);
+
+    // sin(45 deg) = 0.70711
+    CU_ASSERT_EQUAL(geo_sin(GEO_TURN / 8), 23170);
+
+    for(a = -GEO_QUARTER; a <= GEO_QUARTER; ++a)
+    {
+        CU_ASSERT_EQUAL(geo_sin(a), -geo_sin(-a));
+        CU_ASSERT_EQUAL(geo_sin(a + GEO_TURN), geo_sin(a));
+
+        // Near a right angle the sine is too flat to be inverted exactly
+        if(a > -GEO_QUARTER + 16 && a < GEO_QUARTER - 16)
+            CU_ASSERT_EQUAL(geo_asin(geo_sin(a)), a);
+    }
+
+    CU_ASSERT_EQUAL(geo_asin(2 * GEO_ONE), GEO_QUARTER);
+    CU_ASSERT_EQUAL(geo_asin(-2 * GEO_ONE), -GEO_QUARTER);
+}
+
+void geo_ahead()
+{
+    geo_point_t point;
+
+    // The same distance, straight along the beam
+    geo_locate(1000, 1000, USR_MID_POS, &point);
+
+    CU_ASSERT_EQUAL(point.offset, 0);
+    CU_ASSERT_EQUAL(point.angle, GEO_QUARTER);
+    CU_ASSERT(point.range >= 999 && point.range <= 1000);
+    CU_ASSERT(point.x >= -1 && point.x <= 1);
+    CU_ASSERT_EQUAL(point.y, point.range);
+
+    geo_locate(1000, 1000, USR_MIN_POS, &point);
+
+    CU_ASSERT_EQUAL(point.angle, 2 * GEO_QUARTER);
+    CU_ASSERT_EQUAL(point.x, -point.range);
+}
+
+void geo_off_axis()
+{
+    geo_point_t left;
+    geo_point_t right;
+
+    // An object 30 mm to the left and 300 mm ahead, about 5.7 deg, is seen at
+    // 300 mm and 304 mm, rounding included
+    geo_locate(300, 304, USR_MID_POS, &left);
+
+    CU_ASSERT(left.offset >= 14 && left.offset <= 20);
+    CU_ASSERT(left.range >= 300 && left.range <= 303);
+    CU_ASSERT(left.x < -20 && left.x > -40);
+
+    // Finer than the motor positions
+    CU_ASSERT_NOT_EQUAL(left.angle % POS_UNITS, 0);
+
+    // Mirrored on the right
+    geo_locate(304, 300, USR_MID_POS, &right);
+
+    CU_ASSERT_EQUAL(right.offset, -left.offset);
+    CU_ASSERT_EQUAL(right.range, left.range);
+    CU_ASSERT(right.x >= -left.x - 1 && right.x <= -left.x + 1);
+    CU_ASSERT_EQUAL(right.y, left.y);
+
+    // Objects are never out of the beam
+    geo_locate(300, 400, USR_MID_POS, &left);
+    CU_ASSERT_EQUAL(left.offset, GEO_BEAM_HALF);
+
+    geo_locate(400, 300, USR_MID_POS, &right);
+    CU_ASSERT_EQUAL(right.offset, -GEO_BEAM_HALF);
+}
+
+void geo_sensors()
+{
+    geo_point_t point;
+
+    // Settles both sensors in the OK state
+    geo_step(1000, 1000);
+    geo_step(1000, 1000);
+
+    CU_ASSERT_TRUE_FATAL(sensors_get_point(&point));
+    CU_ASSERT_EQUAL(point.offset, 0);
+    CU_ASSERT_EQUAL(point.angle, GEO_POS_TO_ANGLE(USR_MID_POS));
+
+    // The right sensor farther by more than a tick, the object is on the left
+    geo_step(1000, 1000 + DISTANCE_TO_MM(2) + 1);
+
+    CU_ASSERT_TRUE_FATAL(sensors_get_point(&point));
+    CU_ASSERT(point.offset > 0);
+    CU_ASSERT(point.angle > GEO_POS_TO_ANGLE(USR_MID_POS));
+
+    // The angle is the one of the motor position of the trigger
+    sensors_set_bearing(USR_MIN_POS);
+    geo_step(1000, 1000);
+    geo_step(1000, 1000);
+
+    CU_ASSERT_TRUE_FATAL(sensors_get_point(&point));
+    CU_ASSERT_EQUAL(point.angle, GEO_POS_TO_ANGLE(USR_MIN_POS));
+
+    // The object seen by one sensor is not located
+    geo_step(1000, -1);
+
+    CU_ASSERT_FALSE(sensors_get_point(&point));
+}
+
+void geo_add_suites()
+{
+    CU_pSuite geo = CU_add_suite("Geometric Triangolation Testing", geo_suite_init, geo_suite_clean);
+
+    CU_add_test(geo, "Square Root Testing", geo_sqrt);
+    CU_add_test(geo, "Trigonometry Testing", geo_trigonometry);
+    CU_add_test(geo, "Object Ahead Testing", geo_ahead);
+    CU_add_test(geo, "Object Off Axis Testing", geo_off_axis);
+    CU_add_test(geo, "Sensors Point Testing", geo_sensors);
+}
@@ -0,0 +1,143 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "grid.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Occupancy Grid Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define AHEAD_CM    (100)           // Object straight ahead of the sonar
+
+// Row of an object straight ahead of the sonar
+#define ROW(cm)     (((cm) * 10 + GRID_CELL_MM / 2) / GRID_CELL_MM)
+
+int grid_suite_init()
+{
+    grid_init();
+
+    return 0;
+}
+
+int grid_suite_clean()
+{
+    grid_clear();
+
+    return 0;
+}
+
+void grid_axis()
+{
+    uint_t  writes;
+    int_t   row;
+
+    grid_clear();
+
+    writes = grid_update(USR_MID_POS, CM_TO_DISTANCE(AHEAD_CM));
+    CU_ASSERT(writes > ROW(AHEAD_CM) + 1 && writes <= GRID_WRITES_MAX);
+
+    // Free up to the object, then unknown behind it
+    for(row = 0; row < ROW(AHEAD_CM); ++row)
+        CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, row), GRID_MISS);
+
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, ROW(AHEAD_CM)), GRID_HIT);
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, ROW(AHEAD_CM) + 1), 0);
+
+    // Occupied across the beam, the farthest sides being the least likely
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN + 1, ROW(AHEAD_CM)), GRID_HIT_SIDE);
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN - 1, ROW(AHEAD_CM)), GRID_HIT_SIDE);
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN + ROW(AHEAD_CM) / 2, ROW(AHEAD_CM)), 0);
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN + 1, ROW(AHEAD_CM) - 1), 0);
+}
+
+void grid_sides()
+{
+    int_t k;
+
+    grid_clear();
+
+    // Nothing in sight along the first row, on both sides of the sonar
+    CU_ASSERT_EQUAL(grid_update(USR_MIN_POS, SENSOR_DIST_MAX), GRID_RANGE);
+    CU_ASSERT_EQUAL(grid_update(USR_MAX_POS, SENSOR_DIST_MAX), GRID_RANGE);
+
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, 0), 2 * GRID_MISS);
+
+    for(k = 1; k < GRID_RANGE; ++k)
+    {
+        CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN - k, 0), GRID_MISS);
+        CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN + k, 0), GRID_MISS);
+        CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN + k, 1), 0);
+    }
+
+    // Beyond the grid as well
+    CU_ASSERT_EQUAL(grid_update(USR_MAX_POS, CM_TO_DISTANCE(GRID_RANGE * GRID_CELL_MM / 10 + 1)),
+            GRID_RANGE);
+    CU_ASSERT_EQUAL(grid_get(GRID_WIDTH - 1, 0), 2 * GRID_MISS);
+
+    // Out of the sweep
+    CU_ASSERT_EQUAL(grid_update(USR_MAX_POS + 1, CM_TO_DISTANCE(AHEAD_CM)), 0);
+    CU_ASSERT_EQUAL(grid_update(USR_MIN_POS - 1, CM_TO_DISTANCE(AHEAD_CM)), 0);
+    CU_ASSERT_EQUAL(grid_get(-1, 0), 0);
+    CU_ASSERT_EQUAL(grid_get(GRID_WIDTH, 0), 0);
+    CU_ASSERT_EQUAL(grid_get(0, GRID_HEIGHT), 0);
+}
+
+void grid_sweeps()
+{
+    int_t sweep;
+
+    grid_clear();
+
+    // Certainty is limited, so that a moved object is soon forgotten
+    for(sweep = 0; sweep < 30; ++sweep)
+        grid_update(USR_MID_POS, CM_TO_DISTANCE(AHEAD_CM));
+
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, ROW(AHEAD_CM)), GRID_LIMIT);
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, 0), -GRID_LIMIT);
+
+    for(sweep = 0; sweep < 30; ++sweep)
+        grid_update(USR_MID_POS, CM_TO_DISTANCE(2 * AHEAD_CM));
+
+    CU_ASSERT(grid_get(GRID_ORIGIN, ROW(AHEAD_CM)) < 0);
+    CU_ASSERT_EQUAL(grid_get(GRID_ORIGIN, ROW(2 * AHEAD_CM)), GRID_LIMIT);
+}
+
+void grid_bounded()
+{
+    uint_t  writes;
+    uint_t  most = 0;
+    int_t   pos;
+    int_t   cm;
+
+    grid_clear();
+
+    for(pos = USR_MIN_POS; pos <= USR_MAX_POS; ++pos)
+    {
+        for(cm = 0; cm <= GRID_RANGE * GRID_CELL_MM / 10 + 10; ++cm)
+        {
+            writes = grid_update(pos, CM_TO_DISTANCE(cm));
+            most = writes > most ? writes : most;
+        }
+    }
+
+    CU_ASSERT(most <= GRID_WRITES_MAX);
+    CU_ASSERT(most >= GRID_RANGE);
+
+    CU_ASSERT_EQUAL(grid_memory(), GRID_CELLS + GRID_BEARINGS * GRID_RANGE * sizeof(uint16_t));
+}
+
+void grid_add_suites()
+{
+    CU_pSuite grid = CU_add_suite("Occupancy Grid Testing", grid_suite_init, grid_suite_clean);
+
+    CU_add_test(grid, "Beam Axis Testing", grid_axis);
+    CU_add_test(grid, "Side Bearings Testing", grid_sides);
+    CU_add_test(grid, "Sweeps Testing", grid_sweeps);
+    CU_add_test(grid, "Bounded Writes Testing", grid_bounded);
+}
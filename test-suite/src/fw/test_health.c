@@ -0,0 +1,157 @@
+#include <CUnit/CUnit.h>
+
+#include "hal.h"
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                      Sensors Health Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t current_distance();
+
+#define ECHO_DELAY  (10)
+#define ECHO_WIDTH  (100)
+#define LX_WIDTH    (90)
+#define GUARD_TICKS (STEP_GUARD / SYST_PERIOD)
+
+// Echoes of a step with both sensors working or with the left one broken
+static const sim_echo_t health_both[SENSORS_NUM] = { { ECHO_DELAY, LX_WIDTH }, { ECHO_DELAY, ECHO_WIDTH } };
+static const sim_echo_t health_lx_lost[SENSORS_NUM] = { { 0, -1 }, { ECHO_DELAY, ECHO_WIDTH } };
+
+// Simulates the given number of steps with the given echoes
+void health_steps(const sim_echo_t echoes[SENSORS_NUM], int_t steps)
+{
+    int_t i;
+
+    for(i = 0; i < steps; ++i)
+        sim_polling_step(echoes);
+}
+
+int health_suite_init()
+{
+    hal_stub_reset();
+    sensors_init();
+
+    // Sampling stops at the first echo only with a single return
+    sensors_set_returns(1);
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+
+    return 0;
+}
+
+int health_suite_clean()
+{
+    // Statistics start over for the following suites
+    hal_stub_reset();
+    sensors_init();
+
+    health_steps(health_both, 2);
+
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+    sensors_set_returns(SENSOR_RETURNS_DEFAULT);
+
+    return 0;
+}
+
+void health_counts()
+{
+    sensor_health_t health;
+
+    CU_ASSERT_TRUE(sensors_get_health(SENSOR_LX, &health));
+    CU_ASSERT_EQUAL(health.outcomes, 0);
+    CU_ASSERT_FALSE(sensors_get_health(SENSORS_NUM, &health));
+
+    health_steps(health_both, 3);
+
+    CU_ASSERT_TRUE(sensors_get_health(SENSOR_LX, &health));
+    CU_ASSERT_EQUAL(health.outcomes, 3);
+    CU_ASSERT_EQUAL(health.counts[SENSOR_ECHO_OK], 3);
+
+    health_steps(health_lx_lost, 2);
+
+    CU_ASSERT_TRUE(sensors_get_health(SENSOR_LX, &health));
+    CU_ASSERT_EQUAL(health.counts[SENSOR_ECHO_OK], 3);
+    CU_ASSERT_EQUAL(health.counts[SENSOR_ECHO_LOST], 2);
+    CU_ASSERT_FALSE(health.failing);
+
+    // Only the last triggers are counted
+    health_steps(health_both, SENSOR_HEALTH_WINDOW);
+
+    CU_ASSERT_TRUE(sensors_get_health(SENSOR_LX, &health));
+    CU_ASSERT_EQUAL(health.outcomes, SENSOR_HEALTH_WINDOW);
+    CU_ASSERT_EQUAL(health.counts[SENSOR_ECHO_OK], SENSOR_HEALTH_WINDOW);
+    CU_ASSERT_EQUAL(health.counts[SENSOR_ECHO_LOST], 0);
+}
+
+void health_fallback()
+{
+    sensor_health_t health;
+    uint_t          samples;
+
+    health_steps(health_lx_lost, SENSOR_HEALTH_FAIL - 1);
+    CU_ASSERT_EQUAL(sensors_get_single(), -1);
+
+    // The window stays open waiting for the broken sensor
+    samples = sensors_get_step_samples();
+    CU_ASSERT(samples > ECHO_DELAY + ECHO_WIDTH + 1);
+
+    health_steps(health_lx_lost, 1);
+
+    CU_ASSERT_TRUE(sensors_get_health(SENSOR_LX, &health));
+    CU_ASSERT_TRUE(health.failing);
+    CU_ASSERT_TRUE(sensors_get_health(SENSOR_RX, &health));
+    CU_ASSERT_FALSE(health.failing);
+    CU_ASSERT_EQUAL(sensors_get_single(), SENSOR_RX);
+
+    // Then it is not waited for anymore
+    health_steps(health_lx_lost, 1);
+    CU_ASSERT_EQUAL(sensors_get_step_samples(), ECHO_DELAY + ECHO_WIDTH + 1);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void health_no_guard()
+{
+    const sim_echo_t far[SENSORS_NUM] = { { 0, -1 }, { ECHO_DELAY, STEP_MIN / SYST_PERIOD } };
+
+    // A single sensor starts the next step as soon as its echo ended
+    CU_ASSERT_EQUAL(sim_adaptive_step(health_lx_lost), SIM_STEP_TICKS(ECHO_DELAY + ECHO_WIDTH + 1));
+    CU_ASSERT_EQUAL(sim_adaptive_step(far), ECHO_DELAY + STEP_MIN / SYST_PERIOD + 1);
+    CU_ASSERT_EQUAL(sensors_get_single(), SENSOR_RX);
+}
+
+void health_recovery()
+{
+    int_t i;
+
+    // The left sensor keeps being triggered, so it is used again as soon as
+    // most of its echoes come back
+    for(i = 0; i < SENSOR_HEALTH_WINDOW && sensors_get_single() >= 0; ++i)
+        sim_polling_step(health_both);
+
+    CU_ASSERT_EQUAL(sensors_get_single(), -1);
+    CU_ASSERT(i > SENSOR_HEALTH_WINDOW - SENSOR_HEALTH_FAIL);
+
+    // And the distances are merged as before
+    sim_polling_step(health_both);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(LX_WIDTH));
+
+    CU_ASSERT_EQUAL(sim_adaptive_step(health_both), SIM_STEP_TICKS(ECHO_DELAY + ECHO_WIDTH + 1 + GUARD_TICKS));
+}
+
+void health_add_suites()
+{
+    CU_pSuite health = CU_add_suite("Sensors Health Functional Testing", health_suite_init, health_suite_clean);
+
+    CU_add_test(health, "Counters Testing", health_counts);
+    CU_add_test(health, "Single Sensor Fallback Testing", health_fallback);
+    CU_add_test(health, "Single Sensor Step Testing", health_no_guard);
+    CU_add_test(health, "Recovery Testing", health_recovery);
+}
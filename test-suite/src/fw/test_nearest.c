@@ -0,0 +1,171 @@
+#include <stdlib.h>
+
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "nearest.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Nearest Object Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define NEAR        (100)
+#define FAR         (NEAR * 4)
+
+// Scans the distances between two positions, as the reference of the tree,
+// returning the position of the nearest one or -1 if nothing is in sight
+int_t nearest_scan(const distance_t distances[], int_t first, int_t last)
+{
+    int_t best = -1;
+    int_t i;
+
+    for(i = first; i <= last; ++i)
+    {
+        if(distances[i - USR_MIN_POS] < SENSOR_DIST_MAX &&
+                (best < 0 || distances[i - USR_MIN_POS] < distances[best - USR_MIN_POS]))
+            best = i;
+    }
+
+    return best;
+}
+
+int nearest_suite_init()
+{
+    nearest_init();
+
+    return 0;
+}
+
+int nearest_suite_clean()
+{
+    nearest_init();
+
+    return 0;
+}
+
+void nearest_sweep()
+{
+    distance_t  distance;
+    int_t       pos;
+
+    nearest_init();
+
+    CU_ASSERT_FALSE(nearest_get(&pos, &distance));
+    CU_ASSERT_FALSE(nearest_get_sector(USR_MIN_POS, USR_MAX_POS, &pos, &distance));
+
+    nearest_update(USR_MIN_POS, FAR);
+    nearest_update(USR_MAX_POS, NEAR);
+
+    CU_ASSERT_TRUE(nearest_get(&pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MAX_POS);
+    CU_ASSERT_EQUAL(distance, NEAR);
+
+    // The lowest position among equal distances
+    nearest_update(USR_MID_POS, NEAR);
+
+    CU_ASSERT_TRUE(nearest_get(&pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MID_POS);
+
+    // The object leaving the sight
+    nearest_update(USR_MID_POS, SENSOR_DIST_MAX);
+    nearest_update(USR_MAX_POS, SENSOR_DIST_MAX);
+
+    CU_ASSERT_TRUE(nearest_get(&pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MIN_POS);
+    CU_ASSERT_EQUAL(distance, FAR);
+
+    // Out of the sweep
+    nearest_update(USR_MAX_POS + 1, NEAR);
+    nearest_update(USR_MIN_POS - 1, NEAR);
+
+    CU_ASSERT_TRUE(nearest_get(&pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MIN_POS);
+}
+
+void nearest_sectors()
+{
+    distance_t  distance;
+    int_t       pos;
+
+    nearest_init();
+
+    nearest_update(USR_MIN_POS + 10, NEAR);
+    nearest_update(USR_MIN_POS + 20, FAR);
+
+    CU_ASSERT_TRUE(nearest_get_sector(USR_MIN_POS + 11, USR_MAX_POS, &pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MIN_POS + 20);
+    CU_ASSERT_EQUAL(distance, FAR);
+
+    CU_ASSERT_TRUE(nearest_get_sector(USR_MIN_POS + 10, USR_MIN_POS + 10, &pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MIN_POS + 10);
+
+    CU_ASSERT_FALSE(nearest_get_sector(USR_MIN_POS + 11, USR_MIN_POS + 19, &pos, &distance));
+    CU_ASSERT_FALSE(nearest_get_sector(USR_MIN_POS + 20, USR_MIN_POS + 10, &pos, &distance));
+
+    // Clipped to the sweep
+    CU_ASSERT_TRUE(nearest_get_sector(USR_MIN_POS - 10, USR_MAX_POS + 10, &pos, &distance));
+    CU_ASSERT_EQUAL(pos, USR_MIN_POS + 10);
+    CU_ASSERT_FALSE(nearest_get_sector(USR_MAX_POS + 1, USR_MAX_POS + 10, &pos, &distance));
+}
+
+void nearest_random()
+{
+    distance_t  distances[NEAREST_BEARINGS];
+    distance_t  distance;
+    int_t       expected;
+    int_t       first;
+    int_t       last;
+    int_t       pos;
+    int_t       i;
+
+    nearest_init();
+    srand(24);
+
+    for(i = 0; i < NEAREST_BEARINGS; ++i)
+        distances[i] = SENSOR_DIST_MAX;
+
+    // Each distance is set alone, compared with a scan of the sweep and of a
+    // sector, with few distinct distances so that ties are frequent
+    for(i = 0; i < 5000; ++i)
+    {
+        pos = rand() % NEAREST_BEARINGS;
+        distances[pos] = rand() % 4 == 0 ? SENSOR_DIST_MAX : NEAR + rand() % 16;
+
+        nearest_update(pos + USR_MIN_POS, distances[pos]);
+
+        expected = nearest_scan(distances, USR_MIN_POS, USR_MAX_POS);
+
+        CU_ASSERT_EQUAL_FATAL(nearest_get(&pos, &distance), expected >= 0);
+        if(expected >= 0)
+        {
+            CU_ASSERT_EQUAL(pos, expected);
+            CU_ASSERT_EQUAL(distance, distances[expected - USR_MIN_POS]);
+        }
+
+        first = USR_MIN_POS + rand() % NEAREST_BEARINGS;
+        last = first + rand() % (USR_MAX_POS - first + 1);
+        expected = nearest_scan(distances, first, last);
+
+        CU_ASSERT_EQUAL_FATAL(nearest_get_sector(first, last, &pos, &distance), expected >= 0);
+        if(expected >= 0)
+        {
+            CU_ASSERT_EQUAL(pos, expected);
+            CU_ASSERT_EQUAL(distance, distances[expected - USR_MIN_POS]);
+        }
+    }
+}
+
+void nearest_add_suites()
+{
+    CU_pSuite nearest = CU_add_suite("Nearest Object Testing", nearest_suite_init, nearest_suite_clean);
+
+    CU_add_test(nearest, "Sweep Testing", nearest_sweep);
+    CU_add_test(nearest, "Sectors Testing", nearest_sectors);
+    CU_add_test(nearest, "Random Updates Testing", nearest_random);
+}
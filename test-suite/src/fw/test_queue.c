@@ -0,0 +1,200 @@
+#include <CUnit/CUnit.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "queue.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Measures Queue Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define STRESS_RECORDS  (2000000)   // Records passed between the two threads
+
+// Fills a measure whose fields all depend on the given sequence number, so that
+// a torn record is detected
+static void queue_make(measure_t* measure, uint32_t seq)
+{
+    measure->stamp      = seq;
+    measure->distance   = STATIC_CAST(int_t, seq * 7);
+    measure->bearing    = STATIC_CAST(int_t, ~seq);
+    measure->sensor     = STATIC_CAST(uint8_t, seq % SENSORS_NUM);
+    measure->echo_state = STATIC_CAST(uint8_t, seq >> 24);
+}
+
+static bool_t queue_check(const measure_t* measure, uint32_t seq)
+{
+    measure_t expected;
+
+    queue_make(&expected, seq);
+
+    return BOOL(measure->stamp == expected.stamp &&
+            measure->distance == expected.distance &&
+            measure->bearing == expected.bearing &&
+            measure->sensor == expected.sensor &&
+            measure->echo_state == expected.echo_state);
+}
+
+void queue_order()
+{
+    static queue_t  queue;
+    measure_t       measure;
+    uint32_t        i;
+
+    queue_init(&queue);
+
+    CU_ASSERT_FALSE(queue_pop(&queue, &measure));
+
+    // Many times the size, so that the indexes wrap
+    for(i = 0; i < 10 * QUEUE_SIZE; ++i)
+    {
+        queue_make(&measure, i);
+        CU_ASSERT_TRUE(queue_push(&queue, &measure));
+        CU_ASSERT_EQUAL(queue_count(&queue), 1);
+
+        CU_ASSERT_TRUE(queue_pop(&queue, &measure));
+        CU_ASSERT_TRUE(queue_check(&measure, i));
+    }
+
+    CU_ASSERT_EQUAL(queue_count(&queue), 0);
+}
+
+void queue_full()
+{
+    static queue_t  queue;
+    measure_t       measure;
+    uint32_t        i;
+
+    queue_init(&queue);
+
+    for(i = 0; i < QUEUE_SIZE; ++i)
+    {
+        queue_make(&measure, i);
+        CU_ASSERT_TRUE(queue_push(&queue, &measure));
+    }
+
+    // The newest measures are dropped, the queued ones are kept
+    queue_make(&measure, QUEUE_SIZE);
+    CU_ASSERT_FALSE(queue_push(&queue, &measure));
+    CU_ASSERT_EQUAL(queue.dropped, 1);
+    CU_ASSERT_EQUAL(queue_count(&queue), QUEUE_SIZE);
+
+    for(i = 0; i < QUEUE_SIZE; ++i)
+    {
+        CU_ASSERT_TRUE(queue_pop(&queue, &measure));
+        CU_ASSERT_TRUE(queue_check(&measure, i));
+    }
+
+    CU_ASSERT_FALSE(queue_pop(&queue, &measure));
+}
+
+static queue_t stress_queue;
+
+// Producer thread, pushes all the records retrying when the queue is full
+static void* queue_producer(void* arg)
+{
+    measure_t   measure;
+    uint32_t    i;
+
+    for(i = 0; i < STRESS_RECORDS; ++i)
+    {
+        queue_make(&measure, i);
+
+        // Yielding lets the test run also on a single core
+        while(!queue_push(&stress_queue, &measure))
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+void queue_stress()
+{
+    pthread_t   producer;
+    int         created;
+    measure_t   measure;
+    uint32_t    i;
+    uint32_t    torn = 0;
+    uint32_t    missing = 0;
+
+    queue_init(&stress_queue);
+
+    created = pthread_create(&producer, NULL, queue_producer, NULL);
+    CU_ASSERT_EQUAL_FATAL(created, 0);
+
+    for(i = 0; i < STRESS_RECORDS; ++i)
+    {
+        while(!queue_pop(&stress_queue, &measure))
+            sched_yield();
+
+        if(measure.stamp != i)
+            ++missing;
+        else if(!queue_check(&measure, i))
+            ++torn;
+    }
+
+    pthread_join(producer, NULL);
+
+    // Each record arrives once, in order and whole
+    CU_ASSERT_EQUAL(missing, 0);
+    CU_ASSERT_EQUAL(torn, 0);
+    CU_ASSERT_FALSE(queue_pop(&stress_queue, &measure));
+}
+
+void queue_sensors()
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { 10, 100 }, { 10, 120 } };
+    measure_t   measure;
+    int_t       i;
+
+    // Each step consumes the records of its trigger, the queue never fills
+    for(i = 0; i < QUEUE_SIZE; ++i)
+        sim_polling_step(echoes);
+
+    sensors_set_bearing(5);
+    sim_polling_step(echoes);
+
+    // The measures of a step carry the bearing of its trigger
+    sensors_set_bearing(6);
+    sim_polling_step(echoes);
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        CU_ASSERT_TRUE_FATAL(sensors_get_measure(&measure));
+        CU_ASSERT_EQUAL(measure.sensor, i);
+        CU_ASSERT_EQUAL(measure.distance, SIM_DISTANCE(echoes[i].width));
+        CU_ASSERT_EQUAL(measure.bearing, 5);
+        CU_ASSERT_EQUAL(measure.index, 0);
+    }
+
+    // Then the record closing the trigger of each sensor
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        CU_ASSERT_TRUE_FATAL(sensors_get_measure(&measure));
+        CU_ASSERT_EQUAL(measure.sensor, i);
+        CU_ASSERT_EQUAL(measure.distance, SIM_DISTANCE(echoes[i].width));
+        CU_ASSERT_EQUAL(measure.bearing, 5);
+        CU_ASSERT_EQUAL(measure.index, MEASURE_END);
+        CU_ASSERT_EQUAL(measure.echo_state, SENSOR_ECHO_OK);
+    }
+
+    CU_ASSERT_FALSE(sensors_get_measure(&measure));
+    CU_ASSERT_EQUAL(sensors_get_last_distance(), SIM_DISTANCE(echoes[0].width));
+}
+
+void queue_add_suites()
+{
+    CU_pSuite queue = CU_add_suite("Measures Queue Functional Testing", NULL, NULL);
+
+    CU_add_test(queue, "Queue Order Testing", queue_order);
+    CU_add_test(queue, "Queue Full Testing", queue_full);
+    CU_add_test(queue, "Queue Threads Stress Testing", queue_stress);
+    CU_add_test(queue, "Sensors Measures Testing", queue_sensors);
+}
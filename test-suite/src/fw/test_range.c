@@ -0,0 +1,132 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Range Window Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t current_distance();
+
+#define ECHO_DELAY  (10)
+#define RANGE       (40)    // In ticks of the simulation
+#define GUARD_TICKS (STEP_GUARD / SYST_PERIOD)
+
+// Simulates a step with the given echo on both sensors and returns the number
+// of samples taken
+uint_t range_step(int_t delay, int_t width)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { delay, width }, { delay, width } };
+
+    sim_polling_step(echoes);
+
+    return sensors_get_step_samples();
+}
+
+int range_suite_init()
+{
+    // Sampling stops at the first echo only with a single return
+    sensors_set_returns(1);
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+    sensors_set_range(SIM_DISTANCE(RANGE));
+
+    // Settles both sensors in the OK state
+    range_step(ECHO_DELAY, RANGE / 2);
+    range_step(ECHO_DELAY, RANGE / 2);
+
+    return 0;
+}
+
+int range_suite_clean()
+{
+    sensors_set_range(SENSOR_DIST_MAX);
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+    sensors_set_returns(SENSOR_RETURNS_DEFAULT);
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void range_limits()
+{
+    sensors_set_range(0);
+    CU_ASSERT_EQUAL(sensors_get_range(), 1);
+
+    sensors_set_range(SENSOR_DIST_MAX + 1);
+    CU_ASSERT_EQUAL(sensors_get_range(), SENSOR_DIST_MAX);
+
+    sensors_set_range(CM_TO_DISTANCE(20));
+    CU_ASSERT(DISTANCE_TO_CM(sensors_get_range()) >= 20);
+    CU_ASSERT(DISTANCE_TO_CM(sensors_get_range() - 1) < 20);
+
+    sensors_set_range(SIM_DISTANCE(RANGE));
+}
+
+void range_within()
+{
+    // Echoes within the range are measured as usual
+    CU_ASSERT_EQUAL(range_step(ECHO_DELAY, RANGE - 1), ECHO_DELAY + RANGE);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(RANGE - 1));
+}
+
+void range_beyond()
+{
+    // Sampling stops as soon as the echo goes beyond the range, and the echo
+    // is then reported as nothing in sight
+    CU_ASSERT_EQUAL(range_step(ECHO_DELAY, 100), ECHO_DELAY + RANGE + 1);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    // The sensors keep working right after
+    range_step(ECHO_DELAY, RANGE / 2);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(RANGE / 2));
+}
+
+void range_adaptive()
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, 100 }, { ECHO_DELAY, 100 } };
+
+    const sim_echo_t longer[SENSORS_NUM] = { { ECHO_DELAY, 600 }, { ECHO_DELAY, 600 } };
+
+    // The adaptive step shrinks with the range
+    CU_ASSERT_EQUAL(sim_adaptive_step(echoes), SIM_STEP_TICKS(ECHO_DELAY + RANGE + 1 + GUARD_TICKS));
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    // Unless the sensors are still busy with the echo beyond the range
+    CU_ASSERT_EQUAL(sim_adaptive_step(longer), ECHO_DELAY + 600 + 1);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+}
+
+void range_long()
+{
+    // An echo beyond the range still high at the next trigger is handled as a
+    // too long echo
+    range_step(ECHO_DELAY, STEP_PERIOD_TICKS);
+    range_step(ECHO_DELAY - STEP_PERIOD_TICKS, STEP_PERIOD_TICKS);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    range_step(ECHO_DELAY, RANGE / 2);
+    range_step(ECHO_DELAY, RANGE / 2);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(RANGE / 2));
+}
+
+void range_add_suites()
+{
+    CU_pSuite range = CU_add_suite("Range Window Functional Testing", range_suite_init, range_suite_clean);
+
+    CU_add_test(range, "Range Limits Testing", range_limits);
+    CU_add_test(range, "Echo Within Range Testing", range_within);
+    CU_add_test(range, "Echo Beyond Range Testing", range_beyond);
+    CU_add_test(range, "Adaptive Step Range Testing", range_adaptive);
+    CU_add_test(range, "Long Echo Beyond Range Testing", range_long);
+}
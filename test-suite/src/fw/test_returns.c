@@ -0,0 +1,154 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Multiple Echoes Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t current_distance();
+
+#define ECHO_DELAY  (10)
+#define ECHO_WIDTH  (20)
+#define ECHO_GAP    (30)
+#define ECHO_NEXT   (ECHO_WIDTH + ECHO_GAP)
+
+// Simulates a step with count echoes on both sensors and returns the number of
+// samples taken
+uint_t returns_step(int_t count)
+{
+    const sim_echo_t echoes[SENSORS_NUM] =
+    {
+        { ECHO_DELAY, ECHO_WIDTH, ECHO_GAP, count },
+        { ECHO_DELAY, ECHO_WIDTH, ECHO_GAP, count },
+    };
+
+    sim_polling_step(echoes);
+
+    return sensors_get_step_samples();
+}
+
+int returns_suite_init()
+{
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+    sensors_set_returns(3);
+
+    // Settles both sensors in the OK state
+    returns_step(1);
+    returns_step(1);
+
+    return 0;
+}
+
+int returns_suite_clean()
+{
+    sensors_set_returns(SENSOR_RETURNS_DEFAULT);
+    sensors_set_range(SENSOR_DIST_MAX);
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+
+    return 0;
+}
+
+void returns_all()
+{
+    returns_t returns;
+    int_t     i;
+
+    returns_step(3);
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        CU_ASSERT_TRUE(sensors_get_returns(i, &returns));
+        CU_ASSERT_EQUAL_FATAL(returns.num, 3);
+
+        CU_ASSERT_EQUAL(returns.echoes[0].start, 0);
+        CU_ASSERT_EQUAL(returns.echoes[1].start, SIM_DISTANCE(ECHO_NEXT));
+        CU_ASSERT_EQUAL(returns.echoes[2].start, SIM_DISTANCE(2 * ECHO_NEXT));
+        CU_ASSERT_EQUAL(returns.echoes[2].width, SIM_DISTANCE(ECHO_WIDTH));
+        CU_ASSERT_EQUAL(RETURN_DISTANCE(returns.echoes[1]), SIM_DISTANCE(ECHO_NEXT + ECHO_WIDTH));
+    }
+
+    // The nearest echo is still the measured distance
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void returns_limit()
+{
+    returns_t returns;
+
+    // Echoes after the maximum number are not waited for
+    CU_ASSERT_EQUAL(returns_step(5), ECHO_DELAY + 2 * ECHO_NEXT + ECHO_WIDTH + 1);
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_LX, &returns));
+    CU_ASSERT_EQUAL(returns.num, 3);
+
+    // Then the sensors keep working as usual
+    returns_step(1);
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_LX, &returns));
+    CU_ASSERT_EQUAL(returns.num, 1);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void returns_range()
+{
+    returns_t returns;
+
+    // Further echoes are waited for up to the range only
+    sensors_set_range(SIM_DISTANCE(ECHO_NEXT + ECHO_WIDTH));
+
+    CU_ASSERT_EQUAL(returns_step(3), ECHO_DELAY + ECHO_NEXT + ECHO_WIDTH + 1);
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_RX, &returns));
+    CU_ASSERT_EQUAL(returns.num, 2);
+
+    sensors_set_range(SENSOR_DIST_MAX);
+}
+
+void returns_single()
+{
+    returns_t returns;
+
+    // With a single echo the window closes at its end, as usual
+    sensors_set_returns(1);
+
+    CU_ASSERT_EQUAL(returns_step(3), ECHO_DELAY + ECHO_WIDTH + 1);
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_RX, &returns));
+    CU_ASSERT_EQUAL(returns.num, 1);
+
+    sensors_set_returns(0);
+    returns_step(3);
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_RX, &returns));
+    CU_ASSERT_EQUAL(returns.num, 1);
+
+    sensors_set_returns(3);
+}
+
+void returns_lost()
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { 0, -1 }, { ECHO_DELAY, ECHO_WIDTH } };
+    returns_t returns;
+
+    sim_polling_step(echoes);
+
+    CU_ASSERT_FALSE(sensors_get_returns(SENSOR_LX, &returns));
+    CU_ASSERT_EQUAL(returns.num, 0);
+    CU_ASSERT_TRUE(sensors_get_returns(SENSOR_RX, &returns));
+    CU_ASSERT_FALSE(sensors_get_returns(SENSORS_NUM, &returns));
+}
+
+void returns_add_suites()
+{
+    CU_pSuite returns = CU_add_suite("Multiple Echoes Functional Testing", returns_suite_init, returns_suite_clean);
+
+    CU_add_test(returns, "All Echoes Testing", returns_all);
+    CU_add_test(returns, "Echoes Limit Testing", returns_limit);
+    CU_add_test(returns, "Echoes Range Testing", returns_range);
+    CU_add_test(returns, "Single Echo Testing", returns_single);
+    CU_add_test(returns, "Lost Echoes Testing", returns_lost);
+}
@@ -0,0 +1,130 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Gated Sampling Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t current_distance();
+
+#define ECHO_DELAY  (10)
+#define ECHO_WIDTH  (100)
+
+// Both sensors see the same echo
+#define SAME_ECHO(delay, width) { { delay, width }, { delay, width } }
+
+// Simulates a step with the given echo on both sensors and returns the number
+// of samples taken
+uint_t sampling_step(int_t delay, int_t width)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = SAME_ECHO(delay, width);
+
+    sim_polling_step(echoes);
+
+    return sensors_get_step_samples();
+}
+
+int sampling_suite_init()
+{
+    // Sampling stops at the first echo only with a single return
+    sensors_set_returns(1);
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+
+    // Settles both sensors in the OK state
+    sampling_step(ECHO_DELAY, ECHO_WIDTH);
+    sampling_step(ECHO_DELAY, ECHO_WIDTH);
+
+    return 0;
+}
+
+int sampling_suite_clean()
+{
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+    sensors_set_returns(SENSOR_RETURNS_DEFAULT);
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void sampling_gated_echo()
+{
+    // Sampling stops right after the falling edge of both echoes
+    CU_ASSERT_EQUAL(sampling_step(ECHO_DELAY, ECHO_WIDTH), ECHO_DELAY + ECHO_WIDTH + 1);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+
+    CU_ASSERT_EQUAL(sampling_step(0, 1), 2);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(1));
+}
+
+void sampling_gated_different_echoes()
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, 40 }, { ECHO_DELAY, 200 } };
+
+    // The window is kept open by the farthest echo
+    sim_polling_step(echoes);
+
+    CU_ASSERT_EQUAL(sensors_get_step_samples(), ECHO_DELAY + 200 + 1);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(40));
+}
+
+void sampling_gated_lost()
+{
+    // Without echoes sampling stops at the maximum distance
+    CU_ASSERT_EQUAL(sampling_step(0, -1), SIM_DIST_MAX);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    // An echo arriving after the maximum distance is not seen at all
+    CU_ASSERT_EQUAL(sampling_step(SIM_DIST_MAX + 10, ECHO_WIDTH), SIM_DIST_MAX);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    sampling_step(ECHO_DELAY, ECHO_WIDTH);
+    CU_ASSERT_EQUAL(sampling_step(ECHO_DELAY, ECHO_WIDTH), ECHO_DELAY + ECHO_WIDTH + 1);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void sampling_gated_long()
+{
+    // A too long echo is not followed beyond the maximum distance, its end is
+    // found on the echo line by the following triggers
+    CU_ASSERT_EQUAL(sampling_step(ECHO_DELAY, STEP_PERIOD_TICKS), ECHO_DELAY + SIM_DIST_MAX + 1);
+    CU_ASSERT_EQUAL(sampling_step(ECHO_DELAY - STEP_PERIOD_TICKS, STEP_PERIOD_TICKS), 1);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    sampling_step(ECHO_DELAY, ECHO_WIDTH);
+    CU_ASSERT_EQUAL(sampling_step(ECHO_DELAY, ECHO_WIDTH), ECHO_DELAY + ECHO_WIDTH + 1);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void sampling_always()
+{
+    sensors_set_sampling(SENSOR_SAMPLING_ALWAYS);
+
+    sampling_step(ECHO_DELAY, ECHO_WIDTH);
+    CU_ASSERT_EQUAL(sampling_step(ECHO_DELAY, ECHO_WIDTH), STEP_PERIOD_TICKS);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+}
+
+void sampling_add_suites()
+{
+    CU_pSuite sampling = CU_add_suite("Gated Sampling Functional Testing", sampling_suite_init, sampling_suite_clean);
+
+    CU_add_test(sampling, "Gated Echo Testing", sampling_gated_echo);
+    CU_add_test(sampling, "Gated Different Echoes Testing", sampling_gated_different_echoes);
+    CU_add_test(sampling, "Gated Lost Echo Testing", sampling_gated_lost);
+    CU_add_test(sampling, "Gated Long Echo Testing", sampling_gated_long);
+    CU_add_test(sampling, "Always Sampling Testing", sampling_always);
+}
@@ -0,0 +1,201 @@
+#include <stdlib.h>
+
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "segment.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Objects Segmentation Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define NEAR        (100)
+#define FAR         (NEAR + 2 * SEGMENT_GAP_MAX + 100)
+
+// Sets the same distance at the given positions
+void segment_fill(int_t first, int_t last, distance_t distance)
+{
+    int_t i;
+
+    for(i = first; i <= last; ++i)
+        segment_update(i, distance);
+}
+
+// Segments the distances of all the positions at once, as the reference of
+// the incremental segmentation
+int_t segment_scan(const distance_t distances[], segment_t objects[])
+{
+    int_t count = 0;
+    int_t i;
+
+    for(i = 0; i < SEGMENT_BEARINGS; ++i)
+    {
+        if(distances[i] >= SENSOR_DIST_MAX)
+            continue;
+
+        if(i == 0 || distances[i - 1] >= SENSOR_DIST_MAX ||
+                abs(distances[i] - distances[i - 1]) > SEGMENT_GAP_MAX)
+        {
+            objects[count].first = i + USR_MIN_POS;
+            objects[count].nearest = distances[i];
+            ++count;
+        }
+
+        objects[count - 1].last = i + USR_MIN_POS;
+
+        if(distances[i] < objects[count - 1].nearest)
+            objects[count - 1].nearest = distances[i];
+    }
+
+    return count;
+}
+
+int segment_suite_init()
+{
+    segment_init();
+
+    return 0;
+}
+
+int segment_suite_clean()
+{
+    segment_init();
+
+    return 0;
+}
+
+void segment_single()
+{
+    segment_t objects[SEGMENT_MAX];
+
+    segment_init();
+
+    CU_ASSERT_EQUAL(segment_count(), 0);
+    CU_ASSERT_FALSE(segment_get(USR_MID_POS, &objects[0]));
+
+    // A wall slightly turned, with its nearest point at the middle
+    segment_fill(USR_MID_POS - 4, USR_MID_POS + 4, NEAR + 10);
+    segment_update(USR_MID_POS, NEAR);
+
+    CU_ASSERT_EQUAL(segment_count(), 1);
+    CU_ASSERT_EQUAL_FATAL(segment_get_objects(objects), 1);
+    CU_ASSERT_EQUAL(objects[0].first, USR_MID_POS - 4);
+    CU_ASSERT_EQUAL(objects[0].last, USR_MID_POS + 4);
+    CU_ASSERT_EQUAL(objects[0].start, GEO_POS_TO_ANGLE(USR_MID_POS - 4));
+    CU_ASSERT_EQUAL(objects[0].end, GEO_POS_TO_ANGLE(USR_MID_POS + 4));
+    CU_ASSERT_EQUAL(objects[0].angle, GEO_POS_TO_ANGLE(USR_MID_POS));
+    CU_ASSERT_EQUAL(objects[0].nearest, NEAR);
+    CU_ASSERT_EQUAL(objects[0].range, NEAR + 9);
+
+    CU_ASSERT_TRUE(segment_get(USR_MID_POS + 4, &objects[1]));
+    CU_ASSERT_EQUAL(objects[1].first, USR_MID_POS - 4);
+    CU_ASSERT_FALSE(segment_get(USR_MID_POS + 5, &objects[1]));
+
+    // Ends of the sweep and positions out of it
+    segment_update(USR_MIN_POS, NEAR);
+    segment_update(USR_MAX_POS, NEAR);
+    segment_update(USR_MAX_POS + 1, NEAR);
+
+    CU_ASSERT_EQUAL(segment_count(), 3);
+    CU_ASSERT_FALSE(segment_get(USR_MAX_POS + 1, &objects[0]));
+}
+
+void segment_split_merge()
+{
+    segment_t objects[SEGMENT_MAX];
+
+    segment_init();
+    segment_fill(USR_MIN_POS + 10, USR_MIN_POS + 30, NEAR);
+
+    // Nothing in the middle splits the object in two
+    segment_update(USR_MIN_POS + 20, SENSOR_DIST_MAX);
+
+    CU_ASSERT_EQUAL_FATAL(segment_get_objects(objects), 2);
+    CU_ASSERT_EQUAL(objects[0].last, USR_MIN_POS + 19);
+    CU_ASSERT_EQUAL(objects[1].first, USR_MIN_POS + 21);
+
+    // So does a far object in front of the background
+    segment_update(USR_MIN_POS + 20, FAR);
+    CU_ASSERT_EQUAL(segment_count(), 3);
+
+    // The gap closed merges them again
+    segment_update(USR_MIN_POS + 20, NEAR + SEGMENT_GAP_MAX);
+
+    CU_ASSERT_EQUAL_FATAL(segment_get_objects(objects), 1);
+    CU_ASSERT_EQUAL(objects[0].first, USR_MIN_POS + 10);
+    CU_ASSERT_EQUAL(objects[0].last, USR_MIN_POS + 30);
+    CU_ASSERT_EQUAL(objects[0].nearest, NEAR);
+
+    // The object moving away position by position
+    segment_fill(USR_MIN_POS + 10, USR_MIN_POS + 30, SENSOR_DIST_MAX);
+    CU_ASSERT_EQUAL(segment_count(), 0);
+}
+
+void segment_random()
+{
+    distance_t  distances[SEGMENT_BEARINGS];
+    segment_t   expected[SEGMENT_MAX];
+    segment_t   objects[SEGMENT_MAX];
+    int_t       count;
+    int_t       pos;
+    int_t       i;
+    int_t       j;
+
+    segment_init();
+    srand(21);
+
+    for(i = 0; i < SEGMENT_BEARINGS; ++i)
+        distances[i] = SENSOR_DIST_MAX;
+
+    // Each distance is set alone, compared with the segmentation of all of them
+    for(i = 0; i < 5000; ++i)
+    {
+        pos = rand() % SEGMENT_BEARINGS;
+
+        switch(rand() % 4)
+        {
+        case 0:
+            distances[pos] = SENSOR_DIST_MAX;
+            break;
+        case 1:
+            distances[pos] = NEAR + rand() % (4 * SEGMENT_GAP_MAX);
+            break;
+        default:
+            // Near the distance of a next position, mostly joining them
+            distances[pos] = (pos > 0 ? distances[pos - 1] : distances[pos]) +
+                    rand() % (2 * SEGMENT_GAP_MAX + 3) - SEGMENT_GAP_MAX - 1;
+            if(distances[pos] < 1 || distances[pos] >= SENSOR_DIST_MAX)
+                distances[pos] = NEAR;
+            break;
+        }
+
+        segment_update(pos + USR_MIN_POS, distances[pos]);
+
+        count = segment_scan(distances, expected);
+
+        CU_ASSERT_EQUAL_FATAL(segment_count(), count);
+        CU_ASSERT_EQUAL_FATAL(segment_get_objects(objects), count);
+
+        for(j = 0; j < count; ++j)
+        {
+            CU_ASSERT_EQUAL(objects[j].first, expected[j].first);
+            CU_ASSERT_EQUAL(objects[j].last, expected[j].last);
+            CU_ASSERT_EQUAL(objects[j].nearest, expected[j].nearest);
+        }
+    }
+}
+
+void segment_add_suites()
+{
+    CU_pSuite segment = CU_add_suite("Objects Segmentation Testing", segment_suite_init, segment_suite_clean);
+
+    CU_add_test(segment, "Single Object Testing", segment_single);
+    CU_add_test(segment, "Split and Merge Testing", segment_split_merge);
+    CU_add_test(segment, "Random Updates Testing", segment_random);
+}
@@ -0,0 +1,96 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "sound.h"
+#include "thermo_stub.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Speed Of Sound Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Microseconds of echo of an object 1 m far at 0 and 40 Celsius degrees
+#define ECHO_1M_0C      (6036)
+#define ECHO_1M_40C     (5637)
+
+int sound_suite_init()
+{
+    thermo_stub_reset();
+    sound_update();
+
+    return 0;
+}
+
+int sound_suite_clean()
+{
+    thermo_stub_reset();
+    sound_update();
+
+    return 0;
+}
+
+void sound_temperatures()
+{
+    CU_ASSERT_EQUAL(sound_get_temperature(), SOUND_TEMP_DEFAULT);
+
+    thermo_stub_celsius = 23;
+    sound_update();
+    CU_ASSERT_EQUAL(sound_get_temperature(), 23);
+
+    // Temperatures out of the table are clamped
+    sound_set_temperature(SOUND_TEMP_MIN - 1);
+    CU_ASSERT_EQUAL(sound_get_temperature(), SOUND_TEMP_MIN);
+
+    sound_set_temperature(SOUND_TEMP_MAX + 100);
+    CU_ASSERT_EQUAL(sound_get_temperature(), SOUND_TEMP_MAX);
+
+    // The longest distance fits the widest one
+    CU_ASSERT(DISTANCE_TO_MM(SENSOR_DIST_MAX) <= SENSOR_DIST_MAX_MM);
+}
+
+void sound_conversions()
+{
+    // The same echo is farther as the air gets warmer
+    sound_set_temperature(0);
+    CU_ASSERT(DISTANCE_TO_MM(ECHO_1M_0C / DISTANCE_PERIOD) >= 1000 - DISTANCE_TO_MM(1) - 1);
+    CU_ASSERT(DISTANCE_TO_MM(ECHO_1M_0C / DISTANCE_PERIOD) <= 1000);
+    CU_ASSERT_EQUAL(SOUND_MM_TO_US(1000), ECHO_1M_0C);
+
+    sound_set_temperature(40);
+    CU_ASSERT(DISTANCE_TO_MM(ECHO_1M_40C / DISTANCE_PERIOD) >= 1000 - DISTANCE_TO_MM(1) - 1);
+    CU_ASSERT(DISTANCE_TO_MM(ECHO_1M_40C / DISTANCE_PERIOD) <= 1000);
+    CU_ASSERT_EQUAL(SOUND_MM_TO_US(1000), ECHO_1M_40C);
+}
+
+void sound_round_trip()
+{
+    int_t       celsius;
+    int_t       cm;
+
+    // Ranges in cm cover the distance asked, but for the rounding of the two
+    // tables, with the least number of ticks
+    for(celsius = SOUND_TEMP_MIN; celsius <= SOUND_TEMP_MAX; celsius += 5)
+    {
+        sound_set_temperature(celsius);
+
+        for(cm = 1; cm <= 700; ++cm)
+        {
+            CU_ASSERT(DISTANCE_TO_MM(CM_TO_DISTANCE(cm)) >= cm * 10 - 1);
+            CU_ASSERT(DISTANCE_TO_MM(CM_TO_DISTANCE(cm) - 1) < cm * 10 + 1);
+        }
+    }
+}
+
+void sound_add_suites()
+{
+    CU_pSuite sound = CU_add_suite("Speed Of Sound Testing", sound_suite_init, sound_suite_clean);
+
+    CU_add_test(sound, "Temperatures Testing", sound_temperatures);
+    CU_add_test(sound, "Conversions Testing", sound_conversions);
+    CU_add_test(sound, "Round Trip Testing", sound_round_trip);
+}
@@ -0,0 +1,113 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Adaptive Step Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+// Private functions of sensor.c
+extern distance_t current_distance();
+
+#define ECHO_DELAY  (10)
+#define ECHO_WIDTH  (100)
+#define GUARD_TICKS (STEP_GUARD / SYST_PERIOD)
+
+// Simulates an adaptive step with the given echo on both sensors and returns
+// its duration in ticks
+uint_t step_adaptive(int_t delay, int_t width)
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { delay, width }, { delay, width } };
+
+    return sim_adaptive_step(echoes);
+}
+
+int step_suite_init()
+{
+    // Sampling stops at the first echo only with a single return
+    sensors_set_returns(1);
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+
+    // Settles both sensors in the OK state
+    step_adaptive(ECHO_DELAY, ECHO_WIDTH);
+    step_adaptive(ECHO_DELAY, ECHO_WIDTH);
+
+    return 0;
+}
+
+int step_suite_clean()
+{
+    sensors_set_sampling(SENSOR_SAMPLING_MODE);
+    sensors_set_returns(SENSOR_RETURNS_DEFAULT);
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void step_echo()
+{
+    // The step ends a guard time after the falling edge of both echoes, but
+    // not before the servo settled
+    CU_ASSERT_EQUAL(step_adaptive(ECHO_DELAY, ECHO_WIDTH), SIM_STEP_TICKS(ECHO_DELAY + ECHO_WIDTH + 1 + GUARD_TICKS));
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+
+    CU_ASSERT_EQUAL(step_adaptive(0, 1), SIM_STEP_TICKS(2 + GUARD_TICKS));
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(1));
+}
+
+void step_lost()
+{
+    // Without echoes the step ends a guard time after the maximum distance
+    CU_ASSERT_EQUAL(step_adaptive(0, -1), SIM_STEP_TICKS(SIM_DIST_MAX + GUARD_TICKS));
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    step_adaptive(ECHO_DELAY, ECHO_WIDTH);
+    step_adaptive(ECHO_DELAY, ECHO_WIDTH);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void step_stuck()
+{
+    // An echo line stuck high keeps the sensor busy, the step period bounds
+    // the step anyway
+    CU_ASSERT_EQUAL(step_adaptive(ECHO_DELAY, 10 * STEP_PERIOD_TICKS), STEP_PERIOD_TICKS);
+    CU_ASSERT_EQUAL(step_adaptive(-STEP_PERIOD_TICKS, 10 * STEP_PERIOD_TICKS), STEP_PERIOD_TICKS);
+    CU_ASSERT_EQUAL(current_distance(), SENSOR_DIST_MAX);
+
+    // Then measures restart as soon as the line is released
+    step_adaptive(0, -1);
+    step_adaptive(ECHO_DELAY, ECHO_WIDTH);
+    step_adaptive(ECHO_DELAY, ECHO_WIDTH);
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+}
+
+void step_always()
+{
+    // The step does not depend on the sampling mode
+    sensors_set_sampling(SENSOR_SAMPLING_ALWAYS);
+
+    CU_ASSERT_EQUAL(step_adaptive(ECHO_DELAY, ECHO_WIDTH), SIM_STEP_TICKS(ECHO_DELAY + ECHO_WIDTH + 1 + GUARD_TICKS));
+    CU_ASSERT_EQUAL(current_distance(), SIM_DISTANCE(ECHO_WIDTH));
+
+    sensors_set_sampling(SENSOR_SAMPLING_GATED);
+}
+
+void step_add_suites()
+{
+    CU_pSuite step = CU_add_suite("Adaptive Step Functional Testing", step_suite_init, step_suite_clean);
+
+    CU_add_test(step, "Adaptive Echo Testing", step_echo);
+    CU_add_test(step, "Adaptive Lost Echo Testing", step_lost);
+    CU_add_test(step, "Adaptive Stuck Echo Testing", step_stuck);
+    CU_add_test(step, "Adaptive Always Sampling Testing", step_always);
+}
@@ -0,0 +1,221 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "filter.h"
+#include "tracker.h"
+#include "sim.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Bearing Trackers Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define ECHO_DELAY  (10)
+
+#define SWEEP_US    (5000000)       // Time between two visits of a bearing
+#define START       (36000 / DISTANCE_PERIOD)
+#define SPEED       (-600 / DISTANCE_PERIOD)
+                                    // Object approaching, in ticks per second
+
+// Distance of the approaching object after the given sweeps
+#define APPROACHING(sweeps) (START + SPEED * (SWEEP_US / 1000000) * (sweeps))
+
+// Expects the track at a bearing at the given time
+#define TRACK_EQUAL(bearing, now, expected_range, expected_rate) \
+    do { \
+        track_t track; \
+        CU_ASSERT_TRUE(tracker_get(bearing, now, &track)); \
+        CU_ASSERT_EQUAL(track.range, expected_range); \
+        CU_ASSERT_EQUAL(track.rate, expected_rate); \
+    } while(0)
+
+int tracker_suite_init()
+{
+    tracker_init();
+
+    // Echoes are simulated right after an undelayed trigger
+    sensors_set_dither(0);
+
+    return 0;
+}
+
+int tracker_suite_clean()
+{
+    tracker_init();
+    sensors_set_dither(TRIGGER_DITHER_DEFAULT);
+
+    return 0;
+}
+
+void tracker_steady()
+{
+    // Recorded distances of a still object, jittering by a tick
+    const distance_t    recorded[] = { 400, 401, 399, 400, 401, 400, 399, 400 };
+    track_t             track;
+    int_t               i;
+
+    tracker_init();
+
+    CU_ASSERT_FALSE(tracker_get(USR_MIN_POS, 0, &track));
+    CU_ASSERT_EQUAL(track.range, SENSOR_DIST_MAX);
+    CU_ASSERT_EQUAL(track.rate, 0);
+
+    for(i = 0; i < STATIC_CAST(int_t, sizeof(recorded) / sizeof(recorded[0])); ++i)
+        tracker_update(USR_MIN_POS, recorded[i], i * SWEEP_US);
+
+    // Still there, neither approaching nor moving away
+    CU_ASSERT_TRUE(tracker_get(USR_MIN_POS, i * SWEEP_US, &track));
+    CU_ASSERT(track.range >= 399 && track.range <= 401);
+    CU_ASSERT(track.rate >= -1 && track.rate <= 1);
+}
+
+void tracker_motion()
+{
+    int_t i;
+
+    tracker_init();
+
+    // The second distance gives the rate, which is kept while it moves steadily
+    for(i = 0; i < 5; ++i)
+        tracker_update(USR_MIN_POS, APPROACHING(i), i * SWEEP_US);
+
+    TRACK_EQUAL(USR_MIN_POS, 4 * SWEEP_US, APPROACHING(4), SPEED);
+
+    // Predicted before the bearing is visited again
+    TRACK_EQUAL(USR_MIN_POS, 4 * SWEEP_US + SWEEP_US / 2,
+            APPROACHING(4) + SPEED * (SWEEP_US / 1000000) / 2, SPEED);
+    TRACK_EQUAL(USR_MIN_POS, 5 * SWEEP_US, APPROACHING(5), SPEED);
+
+    // Once stopped, the rate decays
+    for(i = 5; i < 20; ++i)
+        tracker_update(USR_MIN_POS, APPROACHING(4), i * SWEEP_US);
+
+    TRACK_EQUAL(USR_MIN_POS, 19 * SWEEP_US, APPROACHING(4), 0);
+}
+
+void tracker_limits()
+{
+    track_t track;
+
+    tracker_init();
+
+    // Predicted up to the sensor, not beyond
+    tracker_update(USR_MIN_POS, -SPEED, 0);
+    tracker_update(USR_MIN_POS, 0, 1000000);
+    TRACK_EQUAL(USR_MIN_POS, 3000000, 0, SPEED);
+
+    // An object not seen any more is forgotten
+    tracker_update(USR_MIN_POS, SENSOR_DIST_MAX, 4000000);
+    CU_ASSERT_FALSE(tracker_get(USR_MIN_POS, 4000000, &track));
+    CU_ASSERT_EQUAL(track.range, SENSOR_DIST_MAX);
+
+    // Too fast to be the same object
+    tracker_update(USR_MIN_POS, 100, 0);
+    tracker_update(USR_MIN_POS, 100 + TRACKER_RATE_MAX + 1, 1000000);
+    TRACK_EQUAL(USR_MIN_POS, 1000000, 100 + TRACKER_RATE_MAX + 1, 0);
+
+    // Another object appearing in front of a tracked one
+    tracker_update(USR_MIN_POS, 100 + TRACKER_RATE_MAX + 1, 2000000);
+    tracker_update(USR_MIN_POS, 100, 3000000);
+    TRACK_EQUAL(USR_MIN_POS, 3000000, 100, 0);
+
+    // Too old to be predicted
+    CU_ASSERT_TRUE(tracker_get(USR_MIN_POS, 3000000 + TRACKER_STALE_US, &track));
+    CU_ASSERT_FALSE(tracker_get(USR_MIN_POS, 3000000 + TRACKER_STALE_US + 1, &track));
+    tracker_update(USR_MIN_POS, 200, 3000000 + TRACKER_STALE_US + 1);
+    TRACK_EQUAL(USR_MIN_POS, 3000000 + TRACKER_STALE_US + 1, 200, 0);
+}
+
+void tracker_bearings()
+{
+    track_t track;
+
+    tracker_init();
+
+    tracker_update(USR_MIN_POS, START, 0);
+    tracker_update(USR_MAX_POS, 300, 0);
+    tracker_update(USR_MIN_POS, START + SPEED, 1000000);
+
+    TRACK_EQUAL(USR_MIN_POS, 1000000, START + SPEED, SPEED);
+    TRACK_EQUAL(USR_MAX_POS, 1000000, 300, 0);
+    CU_ASSERT_FALSE(tracker_get(USR_MID_POS, 1000000, &track));
+
+    // Out of the sweep
+    tracker_update(USR_MAX_POS + 1, 100, 0);
+    CU_ASSERT_FALSE(tracker_get(USR_MAX_POS + 1, 0, &track));
+    CU_ASSERT_FALSE(tracker_get(USR_MIN_POS - 1, 0, &track));
+}
+
+void tracker_sensors()
+{
+    const sim_echo_t    near[SENSORS_NUM] = { { ECHO_DELAY, 100 }, { ECHO_DELAY, 100 } };
+    const sim_echo_t    none[SENSORS_NUM] = { { ECHO_DELAY, -1 }, { ECHO_DELAY, -1 } };
+    const filter_kind_t kinds[] = { FILTER_EMA };
+    track_t             track;
+
+    filter_set_chain(kinds, 1);
+    tracker_init();
+
+    // The echoes of a step belong to the bearing set before the previous one
+    sensors_set_bearing(USR_MID_POS);
+    sim_polling_step(near);
+    sensors_set_bearing(USR_MIN_POS);
+    sim_polling_step(near);
+
+    TRACK_EQUAL(USR_MID_POS, sensors_get_time(), SIM_DISTANCE(100), 0);
+    CU_ASSERT_FALSE(tracker_get(USR_MIN_POS, sensors_get_time(), &track));
+
+    // Nothing seen any more at the next visit
+    sensors_set_bearing(USR_MID_POS);
+    sim_polling_step(none);
+    sim_polling_step(none);
+    CU_ASSERT_FALSE(tracker_get(USR_MID_POS, sensors_get_time(), &track));
+
+    filter_init();
+    tracker_init();
+}
+
+void tracker_spurious()
+{
+    const sim_echo_t    near[SENSORS_NUM] = { { ECHO_DELAY, 100 }, { ECHO_DELAY, 100 } };
+    const sim_echo_t    far[SENSORS_NUM] = { { ECHO_DELAY, 300 }, { ECHO_DELAY, 300 } };
+    const filter_kind_t kinds[] = { FILTER_MEDIAN, FILTER_GATE, FILTER_EMA };
+    int_t               i;
+
+    filter_set_chain(kinds, 3);
+    tracker_init();
+
+    sensors_set_bearing(USR_MID_POS);
+
+    for(i = 0; i < 4; ++i)
+        sim_polling_step(near);
+
+    // A single echo of another object is removed before the track sees it
+    sim_polling_step(far);
+    TRACK_EQUAL(USR_MID_POS, sensors_get_time(), SIM_DISTANCE(100), 0);
+    CU_ASSERT_EQUAL(filter_get_robust(), SIM_DISTANCE(100));
+
+    sim_polling_step(near);
+    TRACK_EQUAL(USR_MID_POS, sensors_get_time(), SIM_DISTANCE(100), 0);
+
+    filter_init();
+    tracker_init();
+}
+
+void tracker_add_suites()
+{
+    CU_pSuite tracker = CU_add_suite("Bearing Trackers Testing", tracker_suite_init, tracker_suite_clean);
+
+    CU_add_test(tracker, "Steady Object Testing", tracker_steady);
+    CU_add_test(tracker, "Moving Object Testing", tracker_motion);
+    CU_add_test(tracker, "Limits Testing", tracker_limits);
+    CU_add_test(tracker, "Bearings Testing", tracker_bearings);
+    CU_add_test(tracker, "Sensors Tracks Testing", tracker_sensors);
+    CU_add_test(tracker, "Spurious Echoes Testing", tracker_spurious);
+}
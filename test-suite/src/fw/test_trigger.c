@@ -0,0 +1,71 @@
+#include <CUnit/CUnit.h>
+
+#include "types.h"
+#include "constants.h"
+
+#include "sensor.h"
+#include "trigger.h"
+#include "sim.h"
+#include "trigger_stub.h"
+
+#include "suites.h"
+
+/* --------------------------------------------------------------------------------
+ *                          Trigger Functional Testing
+ * --------------------------------------------------------------------------------
+ */
+
+#define ECHO_DELAY  (10)
+#define ECHO_WIDTH  (100)
+
+#define TRIGGER_ALL (TRIGGER_SENSOR(SENSOR_LX) | TRIGGER_SENSOR(SENSOR_RX))
+
+int trigger_suite_init()
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, ECHO_WIDTH }, { ECHO_DELAY, ECHO_WIDTH } };
+
+    // Settles both sensors in the OK state
+    sim_polling_step(echoes);
+    sim_polling_step(echoes);
+
+    return 0;
+}
+
+void trigger_all()
+{
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, ECHO_WIDTH }, { ECHO_DELAY, ECHO_WIDTH } };
+
+    trigger_stub_reset();
+
+    sim_polling_step(echoes);
+    CU_ASSERT_EQUAL(trigger_stub_last, TRIGGER_ALL);
+
+    sim_polling_step(echoes);
+    CU_ASSERT_EQUAL(trigger_stub_pulses[SENSOR_LX], 2);
+    CU_ASSERT_EQUAL(trigger_stub_pulses[SENSOR_RX], 2);
+}
+
+void trigger_busy()
+{
+    const sim_echo_t lx_long[SENSORS_NUM] = { { ECHO_DELAY, STEP_PERIOD_TICKS }, { ECHO_DELAY, ECHO_WIDTH } };
+    const sim_echo_t lx_end[SENSORS_NUM] = { { ECHO_DELAY - STEP_PERIOD_TICKS, STEP_PERIOD_TICKS }, { ECHO_DELAY, ECHO_WIDTH } };
+    const sim_echo_t echoes[SENSORS_NUM] = { { ECHO_DELAY, ECHO_WIDTH }, { ECHO_DELAY, ECHO_WIDTH } };
+
+    // A sensor still busy with its echo is not triggered
+    sim_polling_step(lx_long);
+    CU_ASSERT_EQUAL(trigger_stub_last, TRIGGER_SENSOR(SENSOR_RX));
+
+    sim_polling_step(lx_end);
+    CU_ASSERT_EQUAL(trigger_stub_last, TRIGGER_ALL);
+
+    sim_polling_step(echoes);
+    CU_ASSERT_EQUAL(trigger_stub_last, TRIGGER_ALL);
+}
+
+void trigger_add_suites()
+{
+    CU_pSuite trigger = CU_add_suite("Trigger Functional Testing", trigger_suite_init, NULL);
+
+    CU_add_test(trigger, "Trigger All Sensors Testing", trigger_all);
+    CU_add_test(trigger, "Trigger Busy Sensor Testing", trigger_busy);
+}
@@ -0,0 +1,39 @@
+/*
+ * hal_stub.c
+ *
+ * Host implementation of the functions declared in hal_stub.h.
+ *
+ * */
+
+#include <string.h>
+
+#include "hal_stub.h"
+
+GPIO_TypeDef hal_stub_gpio[HAL_STUB_PORTS];
+
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed)
+{
+    int pin;
+
+    for(pin = 0; pin < 16; ++pin)
+    {
+        if(!(GPIO_Pin & (1 << pin)))
+            continue;
+
+        GPIOx->MODER &= ~(0x3u << (2 * pin));
+        GPIOx->MODER |= (uint32_t)GPIO_Mode << (2 * pin);
+    }
+}
+
+void hal_stub_reset(void)
+{
+    memset(hal_stub_gpio, 0, sizeof(hal_stub_gpio));
+}
+
+void hal_stub_set_input(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, int value)
+{
+    if(value)
+        GPIOx->IDR |= GPIO_Pin;
+    else
+        GPIOx->IDR &= ~GPIO_Pin;
+}
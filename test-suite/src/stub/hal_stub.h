@@ -0,0 +1,115 @@
+/*
+ * hal_stub.h
+ *
+ * Host replacement for the subset of the STM32F4 libraries used by the
+ * platform independent modules of the sonar (see sonar/hal.h). GPIO ports are
+ * plain structures in memory, so tests can drive the input lines by writing
+ * their IDR and check the output lines by reading their ODR.
+ *
+ * */
+
+#ifndef HAL_STUB_H
+#define HAL_STUB_H
+
+#include <stdint.h>
+
+/* ---------------------------
+ * GPIO
+ * ---------------------------
+ */
+
+typedef struct
+{
+    uint32_t MODER;     // Mode of each pin, two bits per pin
+    uint16_t IDR;       // Input data, written by the tests
+    uint16_t ODR;       // Output data, read by the tests
+} GPIO_TypeDef;
+
+#define HAL_STUB_PORTS  (5)
+
+extern GPIO_TypeDef hal_stub_gpio[HAL_STUB_PORTS];
+
+#define GPIOA   (&hal_stub_gpio[0])
+#define GPIOB   (&hal_stub_gpio[1])
+#define GPIOC   (&hal_stub_gpio[2])
+#define GPIOD   (&hal_stub_gpio[3])
+#define GPIOE   (&hal_stub_gpio[4])
+
+#define GPIO_Pin_0      ((uint16_t)0x0001)
+#define GPIO_Pin_1      ((uint16_t)0x0002)
+#define GPIO_Pin_2      ((uint16_t)0x0004)
+#define GPIO_Pin_3      ((uint16_t)0x0008)
+#define GPIO_Pin_4      ((uint16_t)0x0010)
+#define GPIO_Pin_5      ((uint16_t)0x0020)
+#define GPIO_Pin_6      ((uint16_t)0x0040)
+#define GPIO_Pin_7      ((uint16_t)0x0080)
+#define GPIO_Pin_8      ((uint16_t)0x0100)
+#define GPIO_Pin_9      ((uint16_t)0x0200)
+#define GPIO_Pin_10     ((uint16_t)0x0400)
+#define GPIO_Pin_11     ((uint16_t)0x0800)
+#define GPIO_Pin_12     ((uint16_t)0x1000)
+#define GPIO_Pin_13     ((uint16_t)0x2000)
+#define GPIO_Pin_14     ((uint16_t)0x4000)
+#define GPIO_Pin_15     ((uint16_t)0x8000)
+
+typedef enum {
+    TM_GPIO_Mode_IN = 0x00,
+    TM_GPIO_Mode_OUT = 0x01,
+    TM_GPIO_Mode_AF = 0x02,
+    TM_GPIO_Mode_AN = 0x03,
+} TM_GPIO_Mode_t;
+
+typedef enum {
+    TM_GPIO_OType_PP = 0x00,
+    TM_GPIO_OType_OD = 0x01
+} TM_GPIO_OType_t;
+
+typedef enum {
+    TM_GPIO_Speed_Low = 0x00,
+    TM_GPIO_Speed_Medium = 0x01,
+    TM_GPIO_Speed_Fast = 0x02,
+    TM_GPIO_Speed_High = 0x03
+} TM_GPIO_Speed_t;
+
+typedef enum {
+    TM_GPIO_PuPd_NOPULL = 0x00,
+    TM_GPIO_PuPd_UP = 0x01,
+    TM_GPIO_PuPd_DOWN = 0x02
+} TM_GPIO_PuPd_t;
+
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed);
+
+// The set/reset registers do not exist here, so outputs are written directly
+#define TM_GPIO_SetPinLow(GPIOx, GPIO_Pin)          ((GPIOx)->ODR &= ~(GPIO_Pin))
+#define TM_GPIO_SetPinHigh(GPIOx, GPIO_Pin)         ((GPIOx)->ODR |= (GPIO_Pin))
+#define TM_GPIO_SetPinValue(GPIOx, GPIO_Pin, val)   ((val) ? TM_GPIO_SetPinHigh(GPIOx, GPIO_Pin) : TM_GPIO_SetPinLow(GPIOx, GPIO_Pin))
+#define TM_GPIO_TogglePinValue(GPIOx, GPIO_Pin)     ((GPIOx)->ODR ^= (GPIO_Pin))
+#define TM_GPIO_GetInputPinValue(GPIOx, GPIO_Pin)   (((GPIOx)->IDR & (GPIO_Pin)) == 0 ? 0 : 1)
+#define TM_GPIO_GetOutputPinValue(GPIOx, GPIO_Pin)  (((GPIOx)->ODR & (GPIO_Pin)) == 0 ? 0 : 1)
+#define TM_GPIO_GetPortInputValue(GPIOx)            ((GPIOx)->IDR)
+
+/* ---------------------------
+ * Interrupts
+ * ---------------------------
+ */
+
+// Nothing interrupts the host tests
+#define HAL_SUSPEND()
+#define HAL_RESUME()
+
+/* ---------------------------
+ * Stub helpers
+ * ---------------------------
+ */
+
+/*
+ * Resets all the ports to inputs, with all lines low.
+ */
+void hal_stub_reset(void);
+
+/*
+ * Drives the given input lines of a port to the given value.
+ */
+void hal_stub_set_input(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, int value);
+
+#endif
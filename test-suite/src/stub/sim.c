@@ -0,0 +1,101 @@
+/*
+ * sim.c
+ *
+ * Host simulation of the sonar timing, see sim.h.
+ *
+ * */
+
+#include "hal.h"
+#include "constants.h"
+#include "sensor.h"
+#include "sensor_config.h"
+#include "alarm.h"
+
+#include "sim.h"
+
+/*
+ * Tells whether the echo line is high the given number of ticks after the
+ * trigger.
+ */
+static int sim_echo_level(const sim_echo_t* echo, int_t tick)
+{
+    int_t i;
+    int_t start;
+
+    for(i = 0; i < echo->count || i == 0; ++i)
+    {
+        start = echo->delay + i * (echo->width + echo->gap);
+
+        if(echo->width >= 0 && tick >= start && tick < start + echo->width)
+            return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Drives each echo line as it is the given number of ticks after the trigger.
+ */
+static void sim_set_echoes(const sim_echo_t echoes[SENSORS_NUM], int_t tick)
+{
+    int_t i;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+        hal_stub_set_input(sensor_pins[i].echo_port, sensor_pins[i].echo_pin,
+                sim_echo_level(&echoes[i], tick));
+}
+
+uint_t sim_polling_step(const sim_echo_t echoes[SENSORS_NUM])
+{
+    int_t tick;
+
+    for(tick = 0; tick < STEP_PERIOD_TICKS; ++tick)
+    {
+        sim_set_echoes(echoes, tick);
+        sensors_read();
+    }
+
+    sensors_send_trigger();
+
+    return STEP_PERIOD_TICKS;
+}
+
+uint_t sim_adaptive_step(const sim_echo_t echoes[SENSORS_NUM])
+{
+    int_t tick;
+
+    for(tick = 0; tick < STEP_PERIOD_TICKS; ++tick)
+    {
+        sim_set_echoes(echoes, tick);
+        sensors_read();
+
+        if(sensors_step_ready())
+        {
+            ++tick;
+            break;
+        }
+    }
+
+    sensors_send_trigger();
+
+    return tick;
+}
+
+int_t sim_alarm_step(const sim_echo_t echoes[SENSORS_NUM])
+{
+    int_t tick;
+    int_t raised = -1;
+
+    for(tick = 0; tick < STEP_PERIOD_TICKS; ++tick)
+    {
+        sim_set_echoes(echoes, tick);
+        sensors_read();
+
+        if(raised < 0 && TM_GPIO_GetOutputPinValue(ALARM_PORT, ALARM_PIN))
+            raised = tick;
+    }
+
+    sensors_send_trigger();
+
+    return raised;
+}
@@ -0,0 +1,66 @@
+/*
+ * sim.h
+ *
+ * Host simulation of the sonar timing, driving the echo lines of the stub while
+ * the sensor module runs as it would on the board.
+ *
+ * */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "types.h"
+#include "sensor.h"
+
+/*
+ * Echo seen by a sensor after a trigger, in ticks since the trigger. A negative
+ * width means that no echo arrives at all, while a negative delay describes an
+ * echo started during a previous step. Sensors giving several echoes repeat
+ * the same echo count times, gap ticks after the end of the previous one.
+ */
+typedef struct
+{
+    int_t delay;    // Ticks from the trigger to the rising edge
+    int_t width;    // Ticks from the rising edge to the falling edge
+    int_t gap;      // Ticks from a falling edge to the following rising edge
+    int_t count;    // Number of echoes, zero means one
+} sim_echo_t;
+
+/*
+ * Distance in number of ticks of an echo lasting the given number of systicks,
+ * which are finer with __SENSOR_HIRES__.
+ */
+#define SIM_DISTANCE(ticks) ((ticks) * (SYST_PERIOD / DISTANCE_PERIOD))
+
+// Systicks of an echo at the maximum distance
+#define SIM_DIST_MAX        (SENSOR_DIST_MAX / SIM_DISTANCE(1))
+
+/*
+ * Simulates a whole step of the polling backend: sensors_read is called once
+ * per systick while each echo line is driven as described by echoes, then the
+ * next trigger is sent. Returns the number of calls of sensors_read.
+ */
+extern uint_t sim_polling_step(const sim_echo_t echoes[SENSORS_NUM]);
+
+/*
+ * Duration in ticks of an adaptive step whose next trigger would be ready the
+ * given ticks after the previous one, never shorter than STEP_MIN.
+ */
+#define SIM_STEP_TICKS(ticks) \
+    ((ticks) > STEP_MIN / SYST_PERIOD ? (ticks) : STEP_MIN / SYST_PERIOD)
+
+/*
+ * Simulates a step as the systick handler runs it with STEP_MODE_ADAPTIVE: the
+ * next trigger is sent as soon as sensors_step_ready tells so. Returns the
+ * number of calls of sensors_read, i.e. the step duration in ticks.
+ */
+extern uint_t sim_adaptive_step(const sim_echo_t echoes[SENSORS_NUM]);
+
+/*
+ * Simulates a step of the polling backend as sim_polling_step, watching the
+ * proximity alarm output after each call of sensors_read. Returns the tick at
+ * which the output was first seen raised, or -1 if it never was.
+ */
+extern int_t sim_alarm_step(const sim_echo_t echoes[SENSORS_NUM]);
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * thermo_stub.c
+ *
+ * Host implementation of the thermometer module, see thermo_stub.h.
+ *
+ * */
+
+#include "sound.h"
+#include "thermo.h"
+#include "thermo_stub.h"
+
+int_t thermo_stub_celsius = SOUND_TEMP_DEFAULT;
+
+void thermo_init()
+{
+    thermo_stub_reset();
+}
+
+int_t thermo_read()
+{
+    return thermo_stub_celsius;
+}
+
+void thermo_stub_reset(void)
+{
+    thermo_stub_celsius = SOUND_TEMP_DEFAULT;
+}
@@ -0,0 +1,24 @@
+/*
+ * thermo_stub.h
+ *
+ * Host replacement for the internal temperature sensor of sonar/thermo.c,
+ * reading a temperature set by the tests.
+ *
+ * */
+
+#ifndef THERMO_STUB_H
+#define THERMO_STUB_H
+
+#include "types.h"
+
+/*
+ * Temperature returned by thermo_read, in Celsius degrees.
+ */
+extern int_t thermo_stub_celsius;
+
+/*
+ * Sets the temperature back to the default of the speed of sound.
+ */
+void thermo_stub_reset(void);
+
+#endif
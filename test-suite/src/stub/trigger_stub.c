@@ -0,0 +1,42 @@
+/*
+ * trigger_stub.c
+ *
+ * Host implementation of the trigger module, see trigger_stub.h.
+ *
+ * */
+
+#include <string.h>
+
+#include "trigger.h"
+#include "trigger_stub.h"
+
+uint_t trigger_stub_last;
+uint_t trigger_stub_delays[SENSORS_NUM];
+uint_t trigger_stub_pulses[SENSORS_NUM];
+
+void trigger_init()
+{
+    trigger_stub_reset();
+}
+
+void trigger_fire(uint_t sensors, const uint_t delays[SENSORS_NUM])
+{
+    int_t i;
+
+    trigger_stub_last = sensors;
+
+    for(i = 0; i < SENSORS_NUM; ++i)
+    {
+        trigger_stub_delays[i] = (sensors & TRIGGER_SENSOR(i)) ? delays[i] : 0;
+
+        if(sensors & TRIGGER_SENSOR(i))
+            ++trigger_stub_pulses[i];
+    }
+}
+
+void trigger_stub_reset(void)
+{
+    trigger_stub_last = 0;
+    memset(trigger_stub_delays, 0, sizeof(trigger_stub_delays));
+    memset(trigger_stub_pulses, 0, sizeof(trigger_stub_pulses));
+}
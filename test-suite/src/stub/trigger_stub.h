@@ -0,0 +1,36 @@
+/*
+ * trigger_stub.h
+ *
+ * Host replacement for the trigger timer of sonar/trigger.c, recording the
+ * pulses that would have been sent to the sensors.
+ *
+ * */
+
+#ifndef TRIGGER_STUB_H
+#define TRIGGER_STUB_H
+
+#include "types.h"
+#include "sensor.h"
+
+/*
+ * Set of sensors triggered by the last call of trigger_fire.
+ */
+extern uint_t trigger_stub_last;
+
+/*
+ * Delay of the pulse of each sensor at the last call of trigger_fire, in
+ * microseconds.
+ */
+extern uint_t trigger_stub_delays[SENSORS_NUM];
+
+/*
+ * Number of pulses sent to each sensor since the last reset.
+ */
+extern uint_t trigger_stub_pulses[SENSORS_NUM];
+
+/*
+ * Clears the recorded pulses.
+ */
+void trigger_stub_reset(void);
+
+#endif